@@ -1,161 +1,771 @@
 #pragma once
 #include "CallRecord.h"
 #include <iostream>
-#include <iomanip>
 #include <string>
+#include <unordered_map>
+#include <vector>
+#include <new>
+#include <algorithm>
+#include <thread>
+#include <fstream>
+#include <cstdlib>
+#include "SlabAllocator.h"
+#include "CdrSegment.h"
+#include "CallStats.h"
+#include "RecordFormatter.h"
 
 using namespace std;
 
+// ɾļ + ʱĹϣFNV-1aֻȡǰ NUMBER_LEN λ
+inline size_t CallKeyHash(const char* number, size_t len, time_t t) {
+    if (len > (size_t)CallRecord::NUMBER_LEN) len = CallRecord::NUMBER_LEN;
+    unsigned long long h = 14695981039346656037ULL;
+    for (size_t i = 0; i < len; ++i) {
+        h ^= (unsigned char)number[i];
+        h *= 1099511628211ULL;
+    }
+    h ^= (unsigned long long)t;
+    h *= 1099511628211ULL;
+    return (size_t)(h ^ (h >> 32));
+}
+
 class CallLog {
 private:
+    static const int MAX_LEVEL = 16;    // ÿ 1/4
+
     CallRecord* head;
     CallRecord* tail;
 
+    // skipHead[i] ǵ i + 1 ıͷnext ָòһڵ㣬prev ָòһڵ
+    SkipLink skipHead[MAX_LEVEL];
+    int maxLevel;           // ǰߵķǿ
+    int tailRank[MAX_LEVEL];    // һڵΣ1 𣬿ղΪ 0
+    int count;              // ¼
+    unsigned int seed;      // ״̬xorshift
+
+    // ͨʹʱ˳򣩣ֻĳһ͵ļ¼
+    CallRecord* typeHead[CALL_TYPE_COUNT];
+    CallRecord* typeTail[CALL_TYPE_COUNT];
+    // ϵýڵ߶ȣtypeSkipHead[t][i] ͬ skipHead[i]
+    SkipLink typeSkipHead[CALL_TYPE_COUNT][MAX_LEVEL];
+
+    // (, ʱ) -> ¼ ĹϣֻϣֵкٱȶԼ¼
+    unordered_multimap<size_t, CallRecord*> keyIndex;
+
+    // ¼㶼ӷֿȡʱͷ
+    SlabAllocator recordPool;
+    vector<SlabAllocator> towerPools;   // towerPools[h - 1] ߶Ϊ h 飨
+
+    //  / άʱܣֻڴеļ¼
+    CallRollup rollup;
+
+    // ڴӳ䷽ʽصʷļֻ
+    CdrSegment history;
+
+    // ½ڵ
+    int randomLevel() {
+        int lv = 0;
+        while (lv < MAX_LEVEL) {
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            if ((seed & 3) != 0) break;
+            ++lv;
+        }
+        return lv;
+    }
+
+    //  i  x ḷ́x Ϊձʾӱͷ 0 㼴ԭ
+    CallRecord* nextAt(CallRecord* x, int i) const {
+        if (i == 0) return x ? x->next : head;
+        return x ? x->links[i - 1].next : skipHead[i - 1].next;
+    }
+
+    //  i 㣨i >= 1 x ӣx Ϊձʾͷ
+    SkipLink& linkAt(CallRecord* x, int i) {
+        return x ? x->links[i - 1] : skipHead[i - 1];
+    }
+
+    const SkipLink& linkAt(CallRecord* x, int i) const {
+        return x ? x->links[i - 1] : skipHead[i - 1];
+    }
+
+    //  i 㣨i >= 1 x ӣx Ϊձʾ͵ıͷ
+    SkipLink& typeLinkAt(CallRecord* x, CallType t, int i) {
+        return x ? x->links[x->level + i - 1] : typeSkipHead[t][i - 1];
+    }
+
+    //  i  x ḷ́ 0 㼴 typeNext
+    CallRecord* typeNextAt(CallRecord* x, CallType t, int i) {
+        if (i == 0) return x ? x->typeNext : typeHead[t];
+        return typeLinkAt(x, t, i).next;
+    }
+
+    //  i  x ǰ 0 㼴ԭ
+    CallRecord* prevAt(CallRecord* x, int i) const {
+        return i == 0 ? x->prev : x->links[i - 1].prev;
+    }
+
+    //  i д x ̵Ŀȣx Ϊձʾͷ
+    int spanAt(CallRecord* x, int i) const {
+        return i == 0 ? 1 : linkAt(x, i).span;
+    }
+
+    // ¼Σ1 𣩣ظǰݵߵĽڵ O(log n)
+    // pred ǿʱ˳ pred[i]i > r->levelΪ r ڵ i ǰ
+    int rankOf(CallRecord* r, CallRecord** pred) const {
+        int rank = 0;
+        CallRecord* x = r;
+        for (int i = r->level; ; ++i) {
+            // ڵ i ˣֱ߶ȳ i Ľڵ
+            while (x->level == i) {
+                CallRecord* p = prevAt(x, i);
+                if (!p) {
+                    // x ǵ i һڵ㣬߲ǰǱͷ
+                    rank += spanAt(nullptr, i);
+                    if (pred) for (int j = i + 1; j <= maxLevel; ++j) pred[j] = nullptr;
+                    return rank;
+                }
+                rank += spanAt(p, i);
+                x = p;
+            }
+            if (pred) pred[i + 1] = x;
+        }
+    }
+
+    // ѽڵժ£ͷţ
+    void unlinkRecord(CallRecord* cur) {
+        CallRecord* pred[MAX_LEVEL + 1];
+        int r = rankOf(cur, pred);
+
+        if (cur->prev) cur->prev->next = cur->next;
+        else head = cur->next;
+        if (cur->next) cur->next->prev = cur->prev;
+        else tail = cur->prev;
+
+        for (int i = 1; i <= cur->level; ++i) {
+            SkipLink& l = cur->links[i - 1];
+            SkipLink& pl = linkAt(l.prev, i);
+            pl.next = l.next;
+            if (l.next) {
+                l.next->links[i - 1].prev = l.prev;
+                pl.span += l.span - 1;
+                --tailRank[i - 1];
+            }
+            else {
+                skipHead[i - 1].prev = l.prev;
+                tailRank[i - 1] = l.prev ? r - pl.span : 0;
+            }
+        }
+        // ߵĲֻѿýڵĿȼһ
+        for (int i = cur->level + 1; i <= maxLevel; ++i) {
+            if (tailRank[i - 1] > r) {
+                --linkAt(pred[i], i).span;
+                --tailRank[i - 1];
+            }
+        }
+        while (maxLevel > 0 && !skipHead[maxLevel - 1].next) --maxLevel;
+        --count;
+
+        CallType t = cur->type;
+        if (cur->typePrev) cur->typePrev->typeNext = cur->typeNext;
+        else typeHead[t] = cur->typeNext;
+        if (cur->typeNext) cur->typeNext->typePrev = cur->typePrev;
+        else typeTail[t] = cur->typePrev;
+        for (int i = 1; i <= cur->level; ++i) {
+            SkipLink& l = typeLinkAt(cur, t, i);
+            typeLinkAt(l.prev, t, i).next = l.next;
+            if (l.next) typeLinkAt(l.next, t, i).prev = l.prev;
+            else typeSkipHead[t][i - 1].prev = l.prev;
+        }
+    }
+
+    // ѽײļ¼
+    void linkType(CallRecord* record) {
+        CallType t = record->type;
+        // update[i] Ϊ¼¼ i ǰձʾͷ
+        CallRecord* update[MAX_LEVEL + 1] = {};
+
+        if (typeTail[t] && typeTail[t]->timestamp <= record->timestamp) {
+            // ¼¼ʱļ¼֮Ҳڸһ֮
+            update[0] = typeTail[t];
+            for (int i = 1; i <= record->level; ++i) update[i] = typeSkipHead[t][i - 1].prev;
+        }
+        else {
+            // 룺ظ͵Զһʱ <= ¼¼ͬͼ¼ O(log n)
+            CallRecord* x = nullptr;
+            for (int i = maxLevel; i >= 0; --i) {
+                CallRecord* nx;
+                while ((nx = typeNextAt(x, t, i)) && nx->timestamp <= record->timestamp) x = nx;
+                update[i] = x;
+            }
+        }
+
+        CallRecord* p = update[0];
+        CallRecord* n = p ? p->typeNext : typeHead[t];
+        record->typePrev = p;
+        record->typeNext = n;
+        if (p) p->typeNext = record;
+        else typeHead[t] = record;
+        if (n) n->typePrev = record;
+        else typeTail[t] = record;
+
+        for (int i = 1; i <= record->level; ++i) {
+            SkipLink& pl = typeLinkAt(update[i], t, i);
+            SkipLink& l = typeLinkAt(record, t, i);
+            l.prev = update[i];
+            l.next = pl.next;
+            if (pl.next) typeLinkAt(pl.next, t, i).prev = record;
+            else typeSkipHead[t][i - 1].prev = record;
+            pl.next = record;
+        }
+    }
+
+    // ײ˳һؽӡԼO(n)
+    void rebuildIndexes() {
+        maxLevel = 0;
+        for (int i = 0; i < MAX_LEVEL; ++i) {
+            skipHead[i].prev = skipHead[i].next = nullptr;
+            skipHead[i].span = 0;
+            tailRank[i] = 0;
+        }
+        resetTypeIndex();
+
+        int r = 0;
+        for (CallRecord* x = head; x; x = x->next) {
+            ++r;
+            for (int i = 1; i <= x->level; ++i) {
+                CallRecord* last = skipHead[i - 1].prev;
+                SkipLink& pl = linkAt(last, i);
+                pl.next = x;
+                pl.span = r - tailRank[i - 1];
+                x->links[i - 1].prev = last;
+                x->links[i - 1].next = nullptr;
+                x->links[i - 1].span = 0;
+                skipHead[i - 1].prev = x;
+                tailRank[i - 1] = r;
+            }
+            if (x->level > maxLevel) maxLevel = x->level;
+
+            CallType t = x->type;
+            x->typePrev = typeTail[t];
+            x->typeNext = nullptr;
+            if (typeTail[t]) typeTail[t]->typeNext = x;
+            else typeHead[t] = x;
+            typeTail[t] = x;
+            for (int i = 1; i <= x->level; ++i) {
+                CallRecord* last = typeSkipHead[t][i - 1].prev;
+                typeLinkAt(last, t, i).next = x;
+                typeLinkAt(x, t, i).prev = last;
+                typeLinkAt(x, t, i).next = nullptr;
+                typeSkipHead[t][i - 1].prev = x;
+            }
+        }
+    }
+
+    void resetTypeIndex() {
+        for (int t = 0; t < CALL_TYPE_COUNT; ++t) {
+            typeHead[t] = typeTail[t] = nullptr;
+            for (int i = 0; i < MAX_LEVEL; ++i) {
+                typeSkipHead[t][i].prev = typeSkipHead[t][i].next = nullptr;
+                typeSkipHead[t][i].span = 0;
+            }
+        }
+    }
+
+    // ʱȶ򣺷ֿ߳й鲢
+    static void parallelSortByTime(vector<CallRecord*>& v) {
+        auto cmp = [](const CallRecord* a, const CallRecord* b) { return a->timestamp < b->timestamp; };
+
+        size_t parts = thread::hardware_concurrency();
+        if (parts == 0 || v.size() < 65536) parts = 1;
+        vector<size_t> bounds(parts + 1);
+        for (size_t k = 0; k <= parts; ++k) bounds[k] = v.size() * k / parts;
+
+        if (parts == 1) {
+            stable_sort(v.begin(), v.end(), cmp);
+            return;
+        }
+
+        vector<thread> workers;
+        for (size_t k = 0; k < parts; ++k) {
+            workers.emplace_back([&v, &bounds, cmp, k] {
+                stable_sort(v.begin() + bounds[k], v.begin() + bounds[k + 1], cmp);
+            });
+        }
+        for (thread& w : workers) w.join();
+
+        for (size_t width = 1; width < parts; width *= 2) {
+            workers.clear();
+            for (size_t k = 0; k + width < parts; k += 2 * width) {
+                size_t lo = bounds[k], mid = bounds[k + width];
+                size_t hi = bounds[k + 2 * width < parts ? k + 2 * width : parts];
+                workers.emplace_back([&v, cmp, lo, mid, hi] {
+                    inplace_merge(v.begin() + lo, v.begin() + mid, v.begin() + hi, cmp);
+                });
+            }
+            for (thread& w : workers) w.join();
+        }
+    }
+
 public:
-    CallLog() : head(nullptr), tail(nullptr) {}
+    CallLog()
+        : head(nullptr), tail(nullptr), maxLevel(0), count(0), seed(2463534242u),
+          recordPool(sizeof(CallRecord))
+    {
+        towerPools.reserve(MAX_LEVEL);
+        size_t perSlab = 4096;
+        for (int h = 1; h <= MAX_LEVEL; ++h) {
+            perSlab = perSlab > 64 ? perSlab / 4 : 16;  // ߶Ϊ h ĽڵԼռ (1/4)^h
+            towerPools.emplace_back(sizeof(SkipLink) * h * 2, perSlab);  //  h 
+        }
+        for (int i = 0; i < MAX_LEVEL; ++i) {
+            skipHead[i].prev = skipHead[i].next = nullptr;
+            skipHead[i].span = 0;
+            tailRank[i] = 0;
+        }
+        resetTypeIndex();
+    }
 
-    // ʱ˳루β¼¼
+    CallLog(const CallLog&) = delete;
+    CallLog& operator=(const CallLog&) = delete;
+
+    // ½һ¼ʱΪǰʱ䣩ڴ鱾־Уٵ insertRecord 
+    CallRecord* createRecord(const string& number, CallType type, int duration) {
+        return new (recordPool.allocate()) CallRecord(number, type, duration);
+    }
+
+    // ½һָʱļ¼ٵ insertRecord 
+    CallRecord* createRecord(const string& number, CallType type, int duration, time_t timestamp) {
+        return new (recordPool.allocate()) CallRecord(number, type, duration, timestamp);
+    }
+
+    // ½һ¼
+    CallRecord* insertRecord(const string& number, CallType type, int duration) {
+        CallRecord* r = createRecord(number, type, duration);
+        insertRecord(r);
+        return r;
+    }
+
+    // ʱ˳루β¼¼ͬһʱļ¼ȺУ
+    // record ɱ־ createRecord 
     void insertRecord(CallRecord* record) {
-        if (!head) {  // 
-            head = tail = record;
+        record->level = (unsigned char)randomLevel();
+        record->links = record->level ? static_cast<SkipLink*>(towerPools[record->level - 1].allocate()) : nullptr;
+        if (record->level > maxLevel) maxLevel = record->level;
+
+        // update[i] Ϊ½ڵڵ i ǰձʾͷrank[i] Ϊ
+        CallRecord* update[MAX_LEVEL + 1] = {};
+        int rank[MAX_LEVEL + 1] = {};
+        if (!tail || tail->timestamp <= record->timestamp) {
+            // ʱ˳򵽴ֱӽӵĩβO(1)
+            update[0] = tail;
+            rank[0] = count;
+            for (int i = 1; i <= record->level; ++i) {
+                update[i] = skipHead[i - 1].prev;
+                rank[i] = tailRank[i - 1];
+            }
+        }
+        else {
+            // 򵽴Զÿһʱ <= ¼¼Ľڵ㣬 O(log n)
+            CallRecord* x = nullptr;
+            int acc = 0;
+            for (int i = maxLevel; i >= 0; --i) {
+                CallRecord* nx;
+                while ((nx = nextAt(x, i)) && nx->timestamp <= record->timestamp) {
+                    acc += spanAt(x, i);
+                    x = nx;
+                }
+                update[i] = x;
+                rank[i] = acc;
+            }
+        }
+        int r = rank[0] + 1;    // ½ڵ
+
+        // ײ˫
+        CallRecord* p = update[0];
+        CallRecord* n = p ? p->next : head;
+        record->prev = p;
+        record->next = n;
+        if (p) p->next = record;
+        else head = record;
+        if (n) n->prev = record;
+        else tail = record;
+        ++count;
+
+        linkType(record);
+        keyIndex.insert({ CallKeyHash(record->number, strlen(record->number), record->timestamp), record });
+        rollup.add(record);
+
+        // 
+        for (int i = 1; i <= record->level; ++i) {
+            SkipLink& pl = linkAt(update[i], i);
+            CallRecord* nx = pl.next;
+            record->links[i - 1].prev = update[i];
+            record->links[i - 1].next = nx;
+            if (nx) {
+                nx->links[i - 1].prev = record;
+                record->links[i - 1].span = pl.span - (r - rank[i]) + 1;
+                ++tailRank[i - 1];
+            }
+            else {
+                skipHead[i - 1].prev = record;
+                record->links[i - 1].span = 0;
+                tailRank[i - 1] = r;
+            }
+            pl.next = record;
+            pl.span = r - rank[i];
+        }
+        // ߵĲֻѿ½ڵĿȼһ˳׷ʱЩ㶼½ڵ֮ǰ
+        if (n) {
+            for (int i = record->level + 1; i <= maxLevel; ++i) {
+                if (tailRank[i - 1] >= r) {
+                    ++linkAt(update[i], i).span;
+                    ++tailRank[i - 1];
+                }
+            }
+        }
+    }
+
+    // 룺ȲٰСѡ뷽ʽ
+    // м¼ʱO(m log n)ֻĶڼ¼㸽ӣ
+    // һι鲢ؽO(n + m)
+    // ͬһʱļ¼м¼ǰڱԭ˳
+    void bulkLoad(const vector<CallEntry>& batch) {
+        if (batch.empty()) return;
+
+        vector<CallRecord*> recs(batch.size());
+        for (size_t i = 0; i < batch.size(); ++i) {
+            const CallEntry& e = batch[i];
+            recs[i] = createRecord(e.number, e.type, e.duration, e.timestamp);
+        }
+        parallelSortByTime(recs);
+
+        // һβ·
+        if (!tail || recs.front()->timestamp >= tail->timestamp) {
+            for (CallRecord* r : recs) insertRecord(r);
             return;
         }
 
-        // ʱ˳루С
-        CallRecord* cur = head;
-        while (cur && cur->timestamp < record->timestamp) {
-            cur = cur->next;
+        // ܴԼ m * log2(n)Сؽ n ʱ
+        size_t logn = 1;
+        while (((size_t)1 << logn) < (size_t)count) ++logn;
+        if (recs.size() * logn < (size_t)count) {
+            for (CallRecord* r : recs) insertRecord(r);
+            return;
         }
 
-        if (!cur) {
-            // 뵽ĩβ
-            record->prev = tail;
-            tail->next = record;
-            tail = record;
+        // 鲢ײ
+        CallRecord* a = head;
+        CallRecord* last = nullptr;
+        size_t j = 0;
+        head = nullptr;
+        while (a || j < recs.size()) {
+            CallRecord* x;
+            if (a && (j == recs.size() || a->timestamp <= recs[j]->timestamp)) {
+                x = a;
+                a = a->next;
+            }
+            else {
+                x = recs[j++];
+            }
+            x->prev = last;
+            if (last) last->next = x;
+            else head = x;
+            last = x;
         }
-        else if (cur == head) {
-            // ͷ
-            record->next = head;
-            head->prev = record;
-            head = record;
+        last->next = nullptr;
+        tail = last;
+        count += (int)recs.size();
+
+        for (CallRecord* r : recs) {
+            r->level = (unsigned char)randomLevel();
+            r->links = r->level ? static_cast<SkipLink*>(towerPools[r->level - 1].allocate()) : nullptr;
+            keyIndex.insert({ CallKeyHash(r->number, strlen(r->number), r->timestamp), r });
+            rollup.add(r);
         }
-        else {
-            // м
-            CallRecord* p = cur->prev;
-            p->next = record;
-            record->prev = p;
+        rebuildIndexes();
+    }
+
+    //  CSV ļ룬ÿиʽ,ʱ,(0/1/2),ʱ
+    // ޷Уͷصļ򲻿 -1
+    int importCsv(const string& path) {
+        ifstream in(path);
+        if (!in) return -1;
 
-            record->next = cur;
-            cur->prev = record;
+        vector<CallEntry> batch;
+        string line;
+        while (getline(in, line)) {
+            size_t c1 = line.find(',');
+            size_t c2 = c1 == string::npos ? c1 : line.find(',', c1 + 1);
+            size_t c3 = c2 == string::npos ? c2 : line.find(',', c2 + 1);
+            if (c3 == string::npos || c1 == 0 || c1 > (size_t)CallRecord::NUMBER_LEN) continue;
+
+            char* end;
+            long long ts = strtoll(line.c_str() + c1 + 1, &end, 10);
+            if (end != line.c_str() + c2) continue;
+            long typ = strtol(line.c_str() + c2 + 1, &end, 10);
+            if (end != line.c_str() + c3 || typ < 0 || typ >= CALL_TYPE_COUNT) continue;
+            long dur = strtol(line.c_str() + c3 + 1, &end, 10);
+            if (end == line.c_str() + c3 + 1) continue;
+
+            batch.push_back(CallEntry{ line.substr(0, c1), (CallType)typ, (int)dur, (time_t)ts });
         }
+        bulkLoad(batch);
+        return (int)batch.size();
+    }
+
+    // ¼
+    int size() const {
+        return count;
+    }
+
+    // ¼ʱ˳е0ʼ O(log n)
+    int getIndexOf(CallRecord* r) const {
+        return r ? rankOf(r, nullptr) - 1 : -1;
     }
 
     // ɾ¼ + ʱ䣩
     bool deleteRecord(const string& number, time_t t) {
-        CallRecord* cur = head;
-
-        while (cur) {
-            if (cur->number == number && cur->timestamp == t) {
+        size_t len = number.size() < (size_t)CallRecord::NUMBER_LEN ? number.size() : (size_t)CallRecord::NUMBER_LEN;
+        auto range = keyIndex.equal_range(CallKeyHash(number.data(), len, t));
+        for (auto it = range.first; it != range.second; ++it) {
+            CallRecord* r = it->second;
+            if (r->timestamp == t && strlen(r->number) == len && memcmp(r->number, number.data(), len) == 0)
+                return deleteRecord(r);
+        }
+        return false;
+    }
 
-                if (cur == head) head = cur->next;
-                if (cur == tail) tail = cur->prev;
-                if (cur->prev) cur->prev->next = cur->next;
-                if (cur->next) cur->next->prev = cur->prev;
+    // ɾ¼¼ָ룬¼ڱٰ
+    bool deleteRecord(CallRecord* r) {
+        if (!r) return false;
 
-                delete cur;
+        auto range = keyIndex.equal_range(CallKeyHash(r->number, strlen(r->number), r->timestamp));
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == r) {
+                keyIndex.erase(it);
+                rollup.remove(r);
+                unlinkRecord(r);
+                if (r->level) towerPools[r->level - 1].deallocate(r->links);
+                recordPool.deallocate(r);
                 return true;
             }
-            cur = cur->next;
         }
         return false;
     }
 
     // ɾָļ¼0ʼ
     bool deleteRecordByIndex(int index) {
-        CallRecord* r = getRecordByIndex(index);
-        if (!r) return false;
-        return deleteRecord(r->number, r->timestamp);
+        return deleteRecord(getRecordByIndex(index));
+    }
+
+    // һʱ >= t ļ¼½ O(log n)
+    CallRecord* lowerBound(time_t t) const {
+        CallRecord* x = nullptr;
+        for (int i = maxLevel; i >= 0; --i) {
+            CallRecord* nx;
+            while ((nx = nextAt(x, i)) && nx->timestamp < t) x = nx;
+        }
+        return x ? x->next : head;
+    }
+
+    // ʱ [t1, t2] ڵÿ¼ visitӶλ㿪ʼǴӱͷ
+    template <class Visitor>
+    void forEachInRange(time_t t1, time_t t2, Visitor visit) const {
+        for (CallRecord* cur = lowerBound(t1); cur && cur->timestamp <= t2; cur = cur->next)
+            visit(cur);
+    }
+
+    // ӡʱ [t1, t2] ڵļ¼
+    void printRange(time_t t1, time_t t2) const {
+        RecordFormatter fmt(cout);
+        int cnt = 0;
+        forEachInRange(t1, t2, [&](CallRecord* r) {
+            fmt.record(r);
+            ++cnt;
+        });
+        if (cnt == 0) fmt.append("(ʱ޼¼)\n");
+    }
+
+    // ܣ롢Ӳѯʱ
+    const CallRollup& stats() const {
+        return rollup;
     }
 
     // Ӿɵ±
-    void traverseForward() {
-        cout << "\nǰ  ¡\n";
+    void traverseForward() const {
+        RecordFormatter fmt(cout);
+        fmt.append("\nǰ  ¡\n");
         CallRecord* cur = head;
         while (cur) {
-            printRecord(cur);
+            fmt.record(cur);
             cur = cur->next;
         }
     }
 
     // µɱ
-    void traverseBackward() {
-        cout << "\n  ɡ\n";
+    void traverseBackward() const {
+        RecordFormatter fmt(cout);
+        fmt.append("\n  ɡ\n");
         CallRecord* cur = tail;
         while (cur) {
-            printRecord(cur);
+            fmt.record(cur);
             cur = cur->prev;
         }
     }
 
     // Ͳ(ʱ)ļ¼
-    CallRecord* findLatestByType(CallType type) {
-        CallRecord* cur = tail;  // ¿ʼ
-        while (cur) {
-            if (cur->type == type) return cur;
-            cur = cur->prev;
-        }
-        return nullptr;
+    CallRecord* findLatestByType(CallType type) const {
+        return typeTail[type];  // β
     }
 
     // ӡ¼
-    void printRecord(CallRecord* r) {
-        tm* t = localtime(&r->timestamp);
+    void printRecord(CallRecord* r) const {
+        printFields(r->number, r->timestamp, r->type, r->duration);
+    }
 
-        cout << ": " << r->number
-            << " | ʱ: " << put_time(t, "%Y-%m-%d %H:%M:%S")
-            << " | : " << TypeToString(r->type)
-            << " | ʱ: " << r->duration << " \n";
+    // ӡļеĵ¼ֱӶȡӳڴ棩
+    void printRecord(const CdrDiskRecord& r) const {
+        printFields(r.number, (time_t)r.timestamp, (CallType)r.type, r.duration);
+    }
+
+    void printFields(const char* number, time_t timestamp, CallType type, int duration) const {
+        RecordFormatter fmt(cout, 128);
+        fmt.record(number, timestamp, type, duration);
     }
 
     // ӡм¼
-    void printAllWithIndex() {
-        cout << "\n | ¼Ϣ\n";
+    void printAllWithIndex() const {
+        RecordFormatter fmt(cout);
+        fmt.append("\n | ¼Ϣ\n");
         int idx = 0;
         CallRecord* cur = head;
         while (cur) {
-            cout << setw(4) << idx << " : ";
-            printRecord(cur);
+            fmt.appendInt(idx, 4);
+            fmt.append(" : ");
+            fmt.record(cur);
             cur = cur->next;
             ++idx;
         }
-        if (idx == 0) cout << "(޼¼)\n";
+        if (idx == 0) fmt.append("(޼¼)\n");
     }
 
-    // ȡ¼ָ루0ʼ
-    CallRecord* getRecordByIndex(int index) {
-        if (index < 0) return nullptr;
-        int idx = 0;
-        CallRecord* cur = head;
-        while (cur) {
-            if (idx == index) return cur;
+    // ҳӡ start ʼ pageSize ¼λ O(log n)
+    void printPage(int start, int pageSize) const {
+        RecordFormatter fmt(cout);
+        fmt.append("\n | ¼Ϣ\n");
+        int idx = start;
+        CallRecord* cur = getRecordByIndex(start);
+        while (cur && idx < start + pageSize) {
+            fmt.appendInt(idx, 4);
+            fmt.append(" : ");
+            fmt.record(cur);
             cur = cur->next;
             ++idx;
         }
-        return nullptr;
+        if (idx == start) fmt.append("(޼¼)\n");
+    }
+
+    // ȡ¼ָ루0ʼ½ O(log n)
+    CallRecord* getRecordByIndex(int index) const {
+        if (index < 0 || index >= count) return nullptr;
+        int target = index + 1;
+        int acc = 0;
+        CallRecord* x = nullptr;
+        for (int i = maxLevel; i >= 0; --i) {
+            CallRecord* nx;
+            while ((nx = nextAt(x, i)) && acc + spanAt(x, i) <= target) {
+                acc += spanAt(x, i);
+                x = nx;
+            }
+            if (acc == target) break;
+        }
+        return x;
     }
 
     // ӡָ͵м¼
-    void printAllByType(CallType type) {
-        cout << "\nг¼" << TypeToString(type) << "\n";
+    void printAllByType(CallType type) const {
+        RecordFormatter fmt(cout);
+        fmt.append("\nг¼");
+        fmt.append(TypeName(type));
+        fmt.append("\n");
         int cnt = 0;
-        CallRecord* cur = head;
+        CallRecord* cur = typeHead[type];   // ֻظ͵
         while (cur) {
-            if (cur->type == type) {
-                printRecord(cur);
-                ++cnt;
-            }
-            cur = cur->next;
+            fmt.record(cur);
+            ++cnt;
+            cur = cur->typeNext;
+        }
+        if (cnt == 0) fmt.append("(δҵ͵ļ¼)\n");
+    }
+
+    // ʷļڴӳ䣬ֻʱ
+    bool openHistory(const string& path) {
+        return history.open(path);
+    }
+
+    size_t historySize() const {
+        return history.size();
+    }
+
+    // ڴеļ¼鵵ļĩβڴƳع鵵
+    // ļֻ׷ӣڶһļ¼޷鵵ڴ
+    int archiveToHistory(const string& path) {
+        CdrSegmentWriter writer;
+        if (!writer.open(path)) return -1;  // 򲻿ʱɶԱֹ
+        history.close();    // ׷ڼ䲻ӳ
+
+        // ʱ򣬴ӵһڶβļ¼ʼ׷
+        time_t last = writer.lastTimestamp();
+        CallRecord* cur = head;
+        while (cur && writer.size() && cur->timestamp < last) cur = cur->next;
+
+        CallRecord* first = cur;
+        int archived = 0;
+        for (; cur; cur = cur->next) {
+            if (!writer.append(*cur)) break;
+            ++archived;
+        }
+        if (!writer.commit()) {
+            writer.abandon();       // ͷδ£дļ¼Ч
+            history.open(path);     // ¹ԭеĶ
+            return -1;
+        }
+        writer.close();
+
+        // ̺ٴڴƳ
+        cur = first;
+        for (int i = 0; i < archived; ++i) {
+            CallRecord* nx = cur->next;
+            deleteRecord(cur);
+            cur = nx;
+        }
+
+        history.open(path);
+        return archived;
+    }
+
+    // ʷ¼  £ֱӳڴ϶ȡ
+    void traverseHistory() const {
+        RecordFormatter fmt(cout);
+        fmt.append("\nʷ¼  ¡\n");
+        for (size_t i = 0; i < history.size(); ++i) {
+            const CdrDiskRecord& r = history[i];
+            fmt.record(r.number, (time_t)r.timestamp, (CallType)r.type, r.duration);
+        }
+        if (history.size() == 0) fmt.append("(ʷ¼)\n");
+    }
+
+    // ӡʷ¼ʱ [t1, t2] ڵļ¼ֶλ
+    void printHistoryRange(time_t t1, time_t t2) const {
+        size_t end = history.upperBound(t2);
+        size_t cnt = 0;
+        RecordFormatter fmt(cout);
+        for (size_t i = history.lowerBound(t1); i < end; ++i, ++cnt) {
+            const CdrDiskRecord& r = history[i];
+            fmt.record(r.number, (time_t)r.timestamp, (CallType)r.type, r.duration);
         }
-        if (cnt == 0) cout << "(δҵ͵ļ¼)\n";
+        if (cnt == 0) fmt.append("(ʱʷ¼)\n");
     }
 };
@@ -1,6 +1,7 @@
 #pragma once
 #include <iostream>
 #include <string>
+#include <cstring>
 #include <ctime>
 
 using namespace std;
@@ -11,7 +12,9 @@ enum CallType {
     MISSED        // δ
 };
 
-string TypeToString(CallType t) {
+const int CALL_TYPE_COUNT = 3;  // ͨ
+
+inline const char* TypeName(CallType t) {
     switch (t) {
     case INCOMING: return "";
     case OUTGOING: return "ȥ";
@@ -20,18 +23,60 @@ string TypeToString(CallType t) {
     }
 }
 
+string TypeToString(CallType t) {
+    return TypeName(t);
+}
+
+struct CallRecord;
+
+// ˫ӣ 0 㼴 CallRecord  prev/next
+struct SkipLink {
+    CallRecord* prev;
+    CallRecord* next;
+    int span;           //  next ֮ĵײڵnext Ϊʱ壩
+};
+
+// ԱСԼ䣻ţٵռöڴ
 struct CallRecord {
-    string number;      // 绰
+    static const int NUMBER_LEN = 20;   // λ
+
     time_t timestamp;   // ʱ
-    CallType type;      // ͨ
-    int duration;       // ʱ룩
 
     CallRecord* prev;
     CallRecord* next;
 
-    CallRecord(string n, CallType t, int d)
-        : number(n), type(t), duration(d), prev(nullptr), next(nullptr)
+    CallRecord* typePrev;   // ͬеǰһ磩
+    CallRecord* typeNext;   // ͬеĺһ£
+
+    SkipLink* links;    // links[i] Ӧ i + 1 㣻links[level + i] Ϊ i + 1 㣨span ã
+
+    int duration;       // ʱ룩
+    CallType type;      // ͨ
+    unsigned char level;    // 0 ʾֻڵײУ
+    char number[NUMBER_LEN + 1];    // 绰루ֽضϣ
+
+    CallRecord(const string& n, CallType t, int d)
+        : CallRecord(n, t, d, time(nullptr)) // Զ¼ǰϵͳʱ
+    {}
+
+    // ָʱʷʱʹã
+    CallRecord(const string& n, CallType t, int d, time_t ts)
+        : timestamp(ts), prev(nullptr), next(nullptr), typePrev(nullptr), typeNext(nullptr), links(nullptr),
+          duration(d), type(t), level(0)
     {
-        timestamp = time(nullptr); // Զ¼ǰϵͳʱ
+        size_t len = n.size() < (size_t)NUMBER_LEN ? n.size() : (size_t)NUMBER_LEN;
+        memcpy(number, n.data(), len);
+        number[len] = '\0';
     }
+
+    CallRecord(const CallRecord&) = delete;
+    CallRecord& operator=(const CallRecord&) = delete;
+};
+
+// õһʱɵ÷
+struct CallEntry {
+    string number;
+    CallType type;
+    int duration;
+    time_t timestamp;
 };
@@ -0,0 +1,160 @@
+#pragma once
+#include "CallRecord.h"
+#include <string>
+#include <cstring>
+#include <map>
+#include <unordered_map>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+// ͨͷֿʱ
+struct CallStats {
+    long long count[CALL_TYPE_COUNT];
+    long long duration[CALL_TYPE_COUNT];   // 
+
+    CallStats() {
+        for (int i = 0; i < CALL_TYPE_COUNT; ++i) count[i] = duration[i] = 0;
+    }
+
+    void add(const CallStats& o) {
+        for (int i = 0; i < CALL_TYPE_COUNT; ++i) {
+            count[i] += o.count[i];
+            duration[i] += o.duration[i];
+        }
+    }
+
+    long long totalCount() const {
+        long long s = 0;
+        for (int i = 0; i < CALL_TYPE_COUNT; ++i) s += count[i];
+        return s;
+    }
+
+    long long totalDuration() const {
+        long long s = 0;
+        for (int i = 0; i < CALL_TYPE_COUNT; ++i) s += duration[i];
+        return s;
+    }
+
+    bool empty() const {
+        return totalCount() == 0;
+    }
+};
+
+// /ɾάĻܣ롢ӡ + 
+class CallRollup {
+public:
+    static const int BUCKET_SECONDS = 60;   // ʱͰȣ1 
+
+private:
+    //  CallRecord һţ㲹 0αȽϺ͹ϣռڴ
+    struct NumberKey {
+        char digits[CallRecord::NUMBER_LEN + 1];
+
+        NumberKey(const char* number, size_t len) {
+            if (len > (size_t)CallRecord::NUMBER_LEN) len = CallRecord::NUMBER_LEN;
+            memset(digits, 0, sizeof(digits));
+            memcpy(digits, number, len);
+        }
+
+        bool operator==(const NumberKey& o) const {
+            return memcmp(digits, o.digits, sizeof(digits)) == 0;
+        }
+    };
+
+    struct NumberKeyHash {
+        size_t operator()(const NumberKey& k) const {
+            unsigned long long h = 14695981039346656037ULL;    // FNV-1a
+            for (size_t i = 0; i < sizeof(k.digits); ++i) {
+                h ^= (unsigned char)k.digits[i];
+                h *= 1099511628211ULL;
+            }
+            return (size_t)(h ^ (h >> 32));
+        }
+    };
+
+    // һĻܣȫʱ + ķǿͰ
+    // ¼ఴʱ䵽Ͱͨ׷ĩβ
+    struct NumberRollup {
+        CallStats total;
+        vector<pair<time_t, CallStats>> buckets;
+    };
+
+    unordered_map<NumberKey, NumberRollup, NumberKeyHash> byNumber;    //  -> ȫʱ + 
+    map<time_t, CallStats> byBucket;                                     //  -> к룬ʱ
+
+    static bool bucketBefore(const pair<time_t, CallStats>& e, time_t b) {
+        return e.first < b;
+    }
+
+    //  delta+1 / -1¼ sؼ s ǷΪ
+    static bool apply(CallStats& s, const CallRecord* r, int delta) {
+        s.count[r->type] += delta;
+        s.duration[r->type] += (long long)delta * r->duration;
+        return s.empty();
+    }
+
+    void update(const CallRecord* r, int delta) {
+        time_t b = bucketOf(r->timestamp);
+
+        NumberKey key(r->number, strlen(r->number));
+        auto a = byNumber.find(key);
+        if (a == byNumber.end()) a = byNumber.emplace(key, NumberRollup()).first;
+        NumberRollup& nr = a->second;
+        auto& v = nr.buckets;
+        auto it = !v.empty() && v.back().first < b ? v.end() : lower_bound(v.begin(), v.end(), b, bucketBefore);
+        if (it == v.end() || it->first != b) it = v.insert(it, make_pair(b, CallStats()));
+        if (apply(it->second, r, delta)) v.erase(it);
+        if (apply(nr.total, r, delta)) byNumber.erase(a);
+
+        auto c = byBucket.find(b);
+        if (c == byBucket.end()) c = byBucket.emplace(b, CallStats()).first;
+        if (apply(c->second, r, delta)) byBucket.erase(c);
+    }
+
+public:
+    static time_t bucketOf(time_t t) {
+        time_t b = t / BUCKET_SECONDS * BUCKET_SECONDS;
+        return b > t ? b - BUCKET_SECONDS : b;  // ʱȡ
+    }
+
+    void add(const CallRecord* r) {
+        update(r, 1);
+    }
+
+    void remove(const CallRecord* r) {
+        update(r, -1);
+    }
+
+    // ĳȫܣO(1)
+    CallStats ofNumber(const string& number) const {
+        auto it = byNumber.find(NumberKey(number.data(), number.size()));
+        return it == byNumber.end() ? CallStats() : it->second.total;
+    }
+
+    // ĳ [from, to] ǸͰڵĻܣӼƣO(log n + ǿͰ)
+    CallStats ofNumber(const string& number, time_t from, time_t to) const {
+        CallStats s;
+        auto a = byNumber.find(NumberKey(number.data(), number.size()));
+        if (a == byNumber.end()) return s;
+        const auto& v = a->second.buckets;
+        for (auto it = lower_bound(v.begin(), v.end(), bucketOf(from), bucketBefore); it != v.end() && it->first <= to; ++it)
+            s.add(it->second);
+        return s;
+    }
+
+    // t һӵĻܣO(log n)
+    CallStats ofMinute(time_t t) const {
+        auto it = byBucket.find(bucketOf(t));
+        return it == byBucket.end() ? CallStats() : it->second;
+    }
+
+    // [from, to] ǸͰĻܣO(log n + ǿͰ)
+    CallStats ofRange(time_t from, time_t to) const {
+        CallStats s;
+        for (auto it = byBucket.lower_bound(bucketOf(from)); it != byBucket.end() && it->first <= to; ++it)
+            s.add(it->second);
+        return s;
+    }
+};
@@ -5,26 +5,158 @@
 #include <string>
 #include <limits>
 #include <cstdlib>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <sstream>
 #include "CallLog.h"
+#include "ConcurrentCallLog.h"
 
 using namespace std;
 
+const string HISTORY_FILE = "call_history.cdr";  // ʷļ
+
 void CleanDOS() {
     system("pause");
     system("cls"); // տ̨Ļ
 }
 
+// дѹ²ԣֱ 1/2/4/8 ߳д룬
+// ڼ̷߳ǷǷֻȫ˶
+void RunIngestBenchmark() {
+    const int PER_PRODUCER = 200000;
+    const int producerCounts[] = { 1, 2, 4, 8 };
+
+    cout << "\n |     | ʱ(ms) | (/) | У\n";
+    for (int producers : producerCounts) {
+        ConcurrentCallLog clog;
+        vector<ConcurrentCallLog::Producer*> handles;
+        for (int p = 0; p < producers; ++p) handles.push_back(clog.createProducer());
+
+        atomic<bool> done(false);
+        atomic<bool> ok(true);
+        thread reader([&] {
+            int lastSize = 0;
+            while (!done.load()) {
+                clog.read([&](const CallLog& snap) {
+                    if (snap.size() < lastSize) ok = false;
+                    lastSize = snap.size();
+                    time_t prev = 0;
+                    int k = 0;
+                    for (CallRecord* r = snap.getRecordByIndex(0); r && k < 1000; r = r->next, ++k) {
+                        if (r->timestamp < prev) ok = false;
+                        prev = r->timestamp;
+                    }
+                });
+            }
+        });
+
+        auto t0 = chrono::steady_clock::now();
+        clog.startMerger(5);
+        vector<thread> workers;
+        for (int p = 0; p < producers; ++p) {
+            workers.emplace_back([&, p] {
+                ConcurrentCallLog::Producer* h = handles[p];
+                string number = to_string(13800000000LL + p);
+                for (int i = 0; i < PER_PRODUCER; ++i) {
+                    // ʱżģ̨Ļ
+                    time_t ts = 1700000000 + i / 10 - (i % 97 == 0 ? 30 : 0);
+                    h->submit(CallEntry{ number, static_cast<CallType>(i % CALL_TYPE_COUNT), i % 600, ts });
+                }
+            });
+        }
+        for (thread& w : workers) w.join();
+        clog.stopMerger();
+        auto t1 = chrono::steady_clock::now();
+        done = true;
+        reader.join();
+
+        clog.read([&](const CallLog& snap) {
+            if (snap.size() != producers * PER_PRODUCER) ok = false;
+            time_t prev = 0;
+            for (CallRecord* r = snap.getRecordByIndex(0); r; r = r->next) {
+                if (r->timestamp < prev) ok = false;
+                prev = r->timestamp;
+            }
+            for (int p = 0; p < producers; ++p) {
+                if (snap.stats().ofNumber(to_string(13800000000LL + p)).totalCount() != PER_PRODUCER) ok = false;
+            }
+        });
+
+        double ms = chrono::duration<double, milli>(t1 - t0).count();
+        cout << setw(8) << producers << " | " << setw(9) << producers * PER_PRODUCER << " | "
+            << setw(8) << fixed << setprecision(1) << ms << " | "
+            << setw(11) << setprecision(0) << producers * PER_PRODUCER / (ms / 1000) << " | "
+            << (ok ? "ͨ" : "ʧ") << "\n";
+        cout.unsetf(ios::fixed);
+        cout << setprecision(6);
+    }
+}
+
+// ʱʽԼ죺ڱʱǰʱлʱ䵹˳
+// ȶ RecordFormatter::appendTime  put_time Сʱز TZ=Australia/Lord_Howe ֤
+void RunTimeFormatCheck() {
+    const time_t STEP = 900;        // ̽лĲ
+    const time_t WINDOW = 7200;     // лȶԵķΧ
+    time_t now = time(nullptr);
+    vector<time_t> switches;
+    tm prev;
+    bool havePrev = false;
+    for (time_t t = now - 3 * 366 * 86400LL; t < now + 2 * 366 * 86400LL; t += STEP) {
+        tm lt;
+        if (!LocalTime(t, lt)) { havePrev = false; continue; }
+        if (havePrev && lt.tm_isdst != prev.tm_isdst) switches.push_back(t);
+        prev = lt;
+        havePrev = true;
+    }
+
+    long long checked = 0, mismatched = 0;
+    for (time_t sw : switches) {
+        for (int dir = -1; dir <= 1; dir += 2) {
+            ostringstream got, expect;
+            {
+                RecordFormatter fmt(got);
+                for (time_t i = 0; i <= 2 * WINDOW; ++i) {
+                    time_t t = dir < 0 ? sw + WINDOW - i : sw - WINDOW + i;
+                    fmt.appendTime(t);
+                    fmt.append("\n");
+                    tm lt;
+                    if (LocalTime(t, lt)) expect << put_time(&lt, "%Y-%m-%d %H:%M:%S") << "\n";
+                    else expect << "0000-00-00 00:00:00\n";
+                }
+            }
+            istringstream g(got.str()), e(expect.str());
+            string a, b;
+            while (getline(e, b)) {
+                getline(g, a);
+                ++checked;
+                if (a != b && mismatched++ == 0) {
+                    cout << "׸һ£" << (dir < 0 ? "" : "˳") << " " << b << "õ " << a << "\n";
+                }
+            }
+        }
+    }
+    cout << "л " << switches.size() << " ȶ " << checked << " һ " << mismatched << " "
+        << (mismatched == 0 ? "ͨ" : "ʧ") << "\n";
+}
+
 int main() {
     CallLog log;
 
+    // ʷڴӳ䣬
+    if (log.openHistory(HISTORY_FILE)) {
+        cout << "Ѽʷ¼ " << log.historySize() << " \n";
+    }
+
     // һʼ伸ʾ¼
-    log.insertRecord(new CallRecord("13800008888", INCOMING, 35));
+    log.insertRecord("13800008888", INCOMING, 35);
     Sleep(1000);
-    log.insertRecord(new CallRecord("19912345678", MISSED, 0));
+    log.insertRecord("19912345678", MISSED, 0);
     Sleep(1000);
-    log.insertRecord(new CallRecord("18019582857", MISSED, 0));
+    log.insertRecord("18019582857", MISSED, 0);
     Sleep(1000);
-    log.insertRecord(new CallRecord("15566667777", OUTGOING, 120));
+    log.insertRecord("15566667777", OUTGOING, 120);
 
     while (true) {
         cout << "===== ͨ¼ϵͳ =====\n";
@@ -34,6 +166,12 @@ int main() {
         cout << "4. ǰ -> £\n";
         cout << "5.  -> ɣ\n";
         cout << "6. Ͳм¼\n";
+        cout << "7. 鵵ǰ¼ʷļ\n";
+        cout << "8. 鿴ʷ¼\n";
+        cout << "9.  CSV ļ\n";
+        cout << "10. ѯ N ӵļ¼ͳ\n";
+        cout << "11. дѹ²\n";
+        cout << "12. ʱʽԼ죨ʱл\n";
         cout << "0. ˳\n";
         cout << "ѡ: ";
 
@@ -67,8 +205,13 @@ int main() {
                 CleanDOS();
                 break;
             }
+            if (number.size() > (size_t)CallRecord::NUMBER_LEN) {
+                cout << " " << CallRecord::NUMBER_LEN << " λȡ\n";
+                CleanDOS();
+                break;
+            }
             CallType ct = static_cast<CallType>(typ);
-            log.insertRecord(new CallRecord(number, ct, dur));
+            log.insertRecord(number, ct, dur);
             cout << "ɹ\n";
             CleanDOS();
             break;
@@ -98,6 +241,53 @@ int main() {
             CleanDOS();
             break;
         }
+        case 7: {
+            int n = log.archiveToHistory(HISTORY_FILE);
+            if (n < 0) cout << "鵵ʧܣ޷д " << HISTORY_FILE << "\n";
+            else cout << "ѹ鵵 " << n << " ¼ʷ¼ " << log.historySize() << " \n";
+            CleanDOS();
+            break;
+        }
+        case 8:
+            log.traverseHistory();
+            CleanDOS();
+            break;
+        case 9: {
+            cout << " CSV ļ·ÿУ,ʱ,,ʱ: ";
+            string path;
+            cin >> path;
+            int n = log.importCsv(path);
+            if (n < 0) cout << "޷ļ\n";
+            else cout << "ѵ " << n << " ¼\n";
+            CleanDOS();
+            break;
+        }
+        case 10: {
+            cout << " N: ";
+            int n;
+            cin >> n;
+            if (n <= 0) { cout << "Ч\n"; CleanDOS(); break; }
+            time_t now = time(nullptr);
+            time_t from = now - (time_t)n * 60;
+            cout << "\n " << n << " ӵļ¼\n";
+            log.printRange(from, now);
+            CallStats s = log.stats().ofRange(from, now);
+            cout << "\nͳƣӣ\n";
+            for (int t = 0; t < CALL_TYPE_COUNT; ++t) {
+                cout << TypeToString(static_cast<CallType>(t)) << ": " << s.count[t]
+                    << " Σ " << s.duration[t] << " \n";
+            }
+            CleanDOS();
+            break;
+        }
+        case 11:
+            RunIngestBenchmark();
+            CleanDOS();
+            break;
+        case 12:
+            RunTimeFormatCheck();
+            CleanDOS();
+            break;
         default:
             cout << "Чѡ\n";
             CleanDOS();
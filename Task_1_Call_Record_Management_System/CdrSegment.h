@@ -0,0 +1,301 @@
+#pragma once
+#include "CallRecord.h"
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// ʷļCDR segmentʽ
+//   [CdrSegmentHeader][CdrDiskRecord x count]
+// ¼ʱֻ׷Ӳ޸ģͷ count / maxTimestamp ÿ׷Ӻд
+// ļĩβ count Ĳݣ׷;жϵ磩һɺ
+
+// 64 λļƫƶλļɳ 2GB
+inline int SeekFile64(FILE* fp, int64_t offset) {
+#ifdef _WIN32
+    return _fseeki64(fp, offset, SEEK_SET);
+#else
+    return fseeko(fp, (off_t)offset, SEEK_SET);
+#endif
+}
+
+inline int64_t TellFile64(FILE* fp) {
+#ifdef _WIN32
+    return _ftelli64(fp);
+#else
+    return (int64_t)ftello(fp);
+#endif
+}
+
+const char CDR_SEGMENT_MAGIC[8] = { 'C', 'D', 'R', 'S', 'E', 'G', '1', '\0' };
+const uint32_t CDR_SEGMENT_VERSION = 1;     // ǰʽ汾汾һɾܾػ׷
+
+#pragma pack(push, 1)
+struct CdrSegmentHeader {
+    char magic[8];          // ̶Ϊ CDR_SEGMENT_MAGIC
+    uint32_t version;       // ʽ汾̶Ϊ CDR_SEGMENT_VERSION
+    uint32_t recordSize;    // ¼ֽУ
+    uint64_t count;         // Ч¼
+    int64_t minTimestamp;   // һ¼ʱ
+    int64_t maxTimestamp;   // һ¼ʱ
+};
+
+struct CdrDiskRecord {
+    int64_t timestamp;                      // ʱ
+    int32_t duration;                       // ʱ룩
+    uint8_t type;                           // ͨ
+    char number[CallRecord::NUMBER_LEN + 1];    // 绰루 '\0' β
+    uint8_t reserved[6];                    // 뵽 40 ֽ
+};
+#pragma pack(pop)
+
+static_assert(sizeof(CdrSegmentHeader) == 40, "CdrSegmentHeader ָı");
+static_assert(sizeof(CdrDiskRecord) == 40, "CdrDiskRecord ָı");
+
+// ֻڴӳ䷽ʽ򿪵Ķļ¼ֱӳڴϷʣл
+class CdrSegment {
+private:
+    const char* base;       // ӳʼַ
+    size_t length;          // ӳ䳤
+    const CdrDiskRecord* records;
+    size_t count;
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#endif
+
+public:
+    CdrSegment() : base(nullptr), length(0), records(nullptr), count(0)
+#ifdef _WIN32
+        , file(INVALID_HANDLE_VALUE), mapping(nullptr)
+#endif
+    {}
+
+    CdrSegment(const CdrSegment&) = delete;
+    CdrSegment& operator=(const CdrSegment&) = delete;
+
+    ~CdrSegment() {
+        close();
+    }
+
+    // ӳļʽʱ false
+    bool open(const string& path) {
+        close();
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER sz;
+        if (!GetFileSizeEx(file, &sz) || sz.QuadPart < (LONGLONG)sizeof(CdrSegmentHeader)) {
+            close();
+            return false;
+        }
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) {
+            close();
+            return false;
+        }
+        base = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        length = (size_t)sz.QuadPart;
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(CdrSegmentHeader)) {
+            ::close(fd);
+            return false;
+        }
+        void* p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+        base = static_cast<const char*>(p);
+        length = (size_t)st.st_size;
+#endif
+        if (!base) {
+            close();
+            return false;
+        }
+
+        const CdrSegmentHeader* h = header();
+        size_t capacity = (length - sizeof(CdrSegmentHeader)) / sizeof(CdrDiskRecord);
+        if (memcmp(h->magic, CDR_SEGMENT_MAGIC, sizeof(h->magic)) != 0 || h->version != CDR_SEGMENT_VERSION ||
+            h->recordSize != sizeof(CdrDiskRecord) || h->count > capacity) {
+            close();
+            return false;
+        }
+        records = reinterpret_cast<const CdrDiskRecord*>(base + sizeof(CdrSegmentHeader));
+        count = (size_t)h->count;
+        return true;
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (base) UnmapViewOfFile(base);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        mapping = nullptr;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (base) munmap(const_cast<char*>(base), length);
+#endif
+        base = nullptr;
+        length = 0;
+        records = nullptr;
+        count = 0;
+    }
+
+    bool isOpen() const {
+        return base != nullptr;
+    }
+
+    const CdrSegmentHeader* header() const {
+        return reinterpret_cast<const CdrSegmentHeader*>(base);
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    const CdrDiskRecord& operator[](size_t i) const {
+        return records[i];
+    }
+
+    // һʱ >= t ļ¼±ֲ꣨ң
+    size_t lowerBound(time_t t) const {
+        size_t lo = 0, hi = count;
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (records[mid].timestamp < (int64_t)t) lo = mid + 1;
+            else hi = mid;
+        }
+        return lo;
+    }
+
+    // һʱ > t ļ¼±ֲ꣨ң
+    size_t upperBound(time_t t) const {
+        size_t lo = 0, hi = count;
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (records[mid].timestamp <= (int64_t)t) lo = mid + 1;
+            else hi = mid;
+        }
+        return lo;
+    }
+};
+
+// ļ׷д½еЧ¼֮׷
+class CdrSegmentWriter {
+private:
+    FILE* fp;
+    CdrSegmentHeader head;
+
+    bool writeHeader() {
+        if (SeekFile64(fp, 0) != 0) return false;
+        if (fwrite(&head, sizeof(head), 1, fp) != 1) return false;
+        return fflush(fp) == 0;
+    }
+
+public:
+    CdrSegmentWriter() : fp(nullptr) {}
+
+    CdrSegmentWriter(const CdrSegmentWriter&) = delete;
+    CdrSegmentWriter& operator=(const CdrSegmentWriter&) = delete;
+
+    ~CdrSegmentWriter() {
+        close();
+    }
+
+    bool open(const string& path) {
+        close();
+        fp = fopen(path.c_str(), "r+b");
+        if (fp) {
+            if (fread(&head, sizeof(head), 1, fp) != 1 ||
+                memcmp(head.magic, CDR_SEGMENT_MAGIC, sizeof(head.magic)) != 0 ||
+                head.version != CDR_SEGMENT_VERSION ||
+                head.recordSize != sizeof(CdrDiskRecord)) {
+                fclose(fp);
+                fp = nullptr;
+                return false;
+            }
+        }
+        else {
+            fp = fopen(path.c_str(), "w+b");
+            if (!fp) return false;
+            memcpy(head.magic, CDR_SEGMENT_MAGIC, sizeof(head.magic));
+            head.version = CDR_SEGMENT_VERSION;
+            head.recordSize = sizeof(CdrDiskRecord);
+            head.count = 0;
+            head.minTimestamp = head.maxTimestamp = 0;
+            if (!writeHeader()) {
+                close();
+                return false;
+            }
+        }
+        // Ч¼֮Ĳݣ count д
+        return SeekFile64(fp, (int64_t)(sizeof(CdrSegmentHeader) + head.count * sizeof(CdrDiskRecord))) == 0;
+    }
+
+    // һ¼ʱ¼¼
+    time_t lastTimestamp() const {
+        return head.count ? (time_t)head.maxTimestamp : 0;
+    }
+
+    uint64_t size() const {
+        return head.count;
+    }
+
+    // ׷һ¼ڶһʱ false
+    bool append(const CallRecord& r) {
+        if (!fp) return false;
+        if (head.count && (int64_t)r.timestamp < head.maxTimestamp) return false;
+
+        CdrDiskRecord d;
+        memset(&d, 0, sizeof(d));
+        d.timestamp = (int64_t)r.timestamp;
+        d.duration = r.duration;
+        d.type = (uint8_t)r.type;
+        memcpy(d.number, r.number, sizeof(d.number));
+        if (fwrite(&d, sizeof(d), 1, fp) != 1) return false;
+
+        if (head.count == 0) head.minTimestamp = d.timestamp;
+        head.maxTimestamp = d.timestamp;
+        ++head.count;
+        return true;
+    }
+
+    // ̺ٻдͷʹ¼¼Ч
+    bool commit() {
+        if (!fp || fflush(fp) != 0) return false;
+        int64_t pos = TellFile64(fp);
+        bool ok = writeHeader();
+        SeekFile64(fp, pos);
+        return ok;
+    }
+
+    void close() {
+        if (fp) {
+            commit();
+            fclose(fp);
+            fp = nullptr;
+        }
+    }
+
+    // ׷ӣдͷֱӹرգļͣϴύ״̬
+    void abandon() {
+        if (fp) {
+            fclose(fp);
+            fp = nullptr;
+        }
+    }
+};
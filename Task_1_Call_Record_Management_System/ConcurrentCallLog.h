@@ -0,0 +1,118 @@
+#pragma once
+#include "CallLog.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// ߲дͨ־
+// ÿдԼĻֻϲ̶߳ݽʱ֮以
+// ϲ̶߳ڰлߣ CallLogСؽ
+// ֹ߳ʣκϲ֮һµĿ
+class ConcurrentCallLog {
+public:
+    // ߵд뻺жα
+    struct alignas(64) Producer {
+        mutex lock;                 // ֻдϲ֮߳̽侺
+        vector<CallEntry> buffer;
+
+        void submit(const CallEntry& e) {
+            lock_guard<mutex> g(lock);
+            buffer.push_back(e);
+        }
+
+        void submit(const string& number, CallType type, int duration) {
+            submit(CallEntry{ number, type, duration, time(nullptr) });
+        }
+    };
+
+private:
+    CallLog log;
+    mutable shared_mutex rw;        // ߹ϲռ
+
+    mutex registry;                 //  producers б
+    vector<unique_ptr<Producer>> producers;
+
+    vector<CallEntry> pending;      // ϲ̵߳Ĺ壬
+    vector<CallEntry> swapBuf;
+    mutex mergeLock;                // ֤ͬһʱֻһϲڽ
+
+    thread merger;
+    atomic<bool> running;
+
+public:
+    ConcurrentCallLog() : running(false) {}
+
+    ConcurrentCallLog(const ConcurrentCallLog&) = delete;
+    ConcurrentCallLog& operator=(const ConcurrentCallLog&) = delete;
+
+    ~ConcurrentCallLog() {
+        stopMerger();
+    }
+
+    // עһߣصĻ鱾Уÿд̸߳һ
+    Producer* createProducer() {
+        lock_guard<mutex> g(registry);
+        producers.push_back(unique_ptr<Producer>(new Producer()));
+        return producers.back().get();
+    }
+
+    // ߻еļ¼鲢־رη
+    size_t publish() {
+        lock_guard<mutex> m(mergeLock);
+        pending.clear();
+        {
+            lock_guard<mutex> g(registry);
+            for (auto& p : producers) {
+                {
+                    lock_guard<mutex> pg(p->lock);
+                    p->buffer.swap(swapBuf);
+                }
+                pending.insert(pending.end(), swapBuf.begin(), swapBuf.end());
+                swapBuf.clear();
+            }
+        }
+        if (pending.empty()) return 0;
+
+        // ռֻǰѱ¼־Ĳ֣־
+        unique_lock<shared_mutex> w(rw);
+        log.bulkLoad(pending);
+        return pending.size();
+    }
+
+    // ̨ϲ̣߳ÿ intervalMs 뷢һ
+    void startMerger(int intervalMs) {
+        if (running.exchange(true)) return;
+        merger = thread([this, intervalMs] {
+            while (running.load()) {
+                this_thread::sleep_for(chrono::milliseconds(intervalMs));
+                publish();
+            }
+        });
+    }
+
+    // ֹ̨ͣϲ̣߳ʣ¼ȫ
+    void stopMerger() {
+        if (running.exchange(false)) merger.join();
+        publish();
+    }
+
+    // һ¿ִֻʣֹڼ䲻кϲ
+    template <class Reader>
+    void read(Reader reader) const {
+        shared_lock<shared_mutex> r(rw);
+        reader(const_cast<const CallLog&>(log));
+    }
+
+    // Զռʽʵײ־ɾ޸Ĳ
+    template <class Writer>
+    void write(Writer writer) {
+        unique_lock<shared_mutex> w(rw);
+        writer(log);
+    }
+};
@@ -0,0 +1,150 @@
+#pragma once
+#include "CallRecord.h"
+#include <charconv>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+// ̰߳ȫıʱתɹ true
+inline bool LocalTime(time_t t, tm& out) {
+#ifdef _WIN32
+    return localtime_s(&out, &t) == 0;
+#else
+    return localtime_r(&t, &out) != nullptr;
+#endif
+}
+
+// ¼ʽȰıƴ󻺳˻ʱһд
+// ֶ operator<<  localtime / put_time
+// ʱ䰴Сʱ "YYYY-MM-DD HH:" ǰ׺֮ͬһСʱڵļ¼ֻ㲹Ϸ֡롣
+// ֻ [ʵתʱ, Сʱ) ãллǰƫƵ㣬󲻻Խ
+// ǰԽĻز Lord Howe زСʱһת
+// ÿʵֻһ߳ʹã̸ͬ߳
+class RecordFormatter {
+private:
+    ostream& out;
+    vector<char> buf;
+    size_t len;
+
+    time_t hourStart;       // ǰ׺ӦСʱʼʱתʱƫ㣩
+    time_t cacheFrom;       // ʵתʱĲû
+    bool hourValid;
+    char hourPrefix[16];    // "YYYY-MM-DD HH:"14 ֽ
+
+    void reserve(size_t n) {
+        if (len + n > buf.size()) {
+            flush();
+            if (n > buf.size()) buf.resize(n);
+        }
+    }
+
+    static void put2(char* p, int v) {
+        p[0] = (char)('0' + v / 10);
+        p[1] = (char)('0' + v % 10);
+    }
+
+    void cacheHour(time_t t) {
+        tm lt;
+        if (!LocalTime(t, lt)) {
+            hourValid = false;
+            return;
+        }
+        cacheFrom = t;
+        hourStart = t - (lt.tm_min * 60 + lt.tm_sec);
+        char* p = hourPrefix;
+        auto r = to_chars(p, p + 6, lt.tm_year + 1900);
+        p = r.ptr;
+        *p++ = '-';
+        put2(p, lt.tm_mon + 1); p += 2;
+        *p++ = '-';
+        put2(p, lt.tm_mday); p += 2;
+        *p++ = ' ';
+        put2(p, lt.tm_hour); p += 2;
+        *p++ = ':';
+        *p = '\0';
+        hourValid = true;
+    }
+
+public:
+    explicit RecordFormatter(ostream& os, size_t capacity = 1 << 20)
+        : out(os), buf(capacity), len(0), hourStart(0), cacheFrom(0), hourValid(false)
+    {
+        hourPrefix[0] = '\0';
+    }
+
+    RecordFormatter(const RecordFormatter&) = delete;
+    RecordFormatter& operator=(const RecordFormatter&) = delete;
+
+    ~RecordFormatter() {
+        flush();
+    }
+
+    void flush() {
+        if (len) out.write(buf.data(), (streamsize)len);
+        len = 0;
+    }
+
+    void append(const char* s, size_t n) {
+        reserve(n);
+        memcpy(buf.data() + len, s, n);
+        len += n;
+    }
+
+    void append(const char* s) {
+        append(s, strlen(s));
+    }
+
+    void appendInt(long long v) {
+        reserve(24);
+        char* p = buf.data() + len;
+        len += to_chars(p, p + 24, v).ptr - p;
+    }
+
+    // Ҷ뵽 width Уͬ setw(width) << v
+    void appendInt(long long v, int width) {
+        char tmp[24];
+        size_t n = to_chars(tmp, tmp + sizeof(tmp), v).ptr - tmp;
+        reserve(n + width);
+        for (size_t i = n; i < (size_t)width; ++i) buf[len++] = ' ';
+        memcpy(buf.data() + len, tmp, n);
+        len += n;
+    }
+
+    // "YYYY-MM-DD HH:MM:SS"
+    void appendTime(time_t t) {
+        if (!hourValid || t < cacheFrom || t >= hourStart + 3600) cacheHour(t);
+        if (!hourValid) {
+            append("0000-00-00 00:00:00");   // ޷תʱ
+            return;
+        }
+        int sec = (int)(t - hourStart);
+        size_t n = strlen(hourPrefix);
+        reserve(n + 5);
+        memcpy(buf.data() + len, hourPrefix, n);
+        char* p = buf.data() + len + n;
+        put2(p, sec / 60);
+        p[2] = ':';
+        put2(p + 3, sec % 60);
+        len += n + 5;
+    }
+
+    // һ¼ʽ CallLog::printRecord ͬ
+    void record(const char* number, time_t timestamp, CallType type, int duration) {
+        append(": ");
+        append(number);
+        append(" | ʱ: ");
+        appendTime(timestamp);
+        append(" | : ");
+        append(TypeName(type));
+        append(" | ʱ: ");
+        appendInt(duration);
+        append(" \n");
+    }
+
+    void record(const CallRecord* r) {
+        record(r->number, r->timestamp, r->type, r->duration);
+    }
+};
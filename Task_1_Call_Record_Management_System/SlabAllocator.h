@@ -0,0 +1,73 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+using namespace std;
+
+// ķֿ飨slab
+// һϵͳһڴ棬ٰСз֣ͷŵĶҵϸã
+// ʱ黹 delete
+class SlabAllocator {
+private:
+    size_t objSize;         // ռõֽѰָС룩
+    size_t perSlab;         // ÿɵĶ
+    vector<char*> slabs;    // п
+    size_t used;            // ǰһгĶ
+    void* freeList;         // жָڶǰֽ
+
+public:
+    SlabAllocator(size_t objectSize, size_t objectsPerSlab = 4096)
+        : perSlab(objectsPerSlab), used(objectsPerSlab), freeList(nullptr)
+    {
+        const size_t align = alignof(void*) > alignof(long long) ? alignof(void*) : alignof(long long);
+        if (objectSize < sizeof(void*)) objectSize = sizeof(void*);
+        objSize = (objectSize + align - 1) / align * align;
+    }
+
+    SlabAllocator(SlabAllocator&& o) noexcept
+        : objSize(o.objSize), perSlab(o.perSlab), slabs(move(o.slabs)), used(o.used), freeList(o.freeList)
+    {
+        o.used = o.perSlab;
+        o.freeList = nullptr;
+    }
+
+    SlabAllocator(const SlabAllocator&) = delete;
+    SlabAllocator& operator=(const SlabAllocator&) = delete;
+
+    ~SlabAllocator() {
+        releaseAll();
+    }
+
+    // һСδʼڴ
+    void* allocate() {
+        if (freeList) {
+            void* p = freeList;
+            freeList = *static_cast<void**>(p);
+            return p;
+        }
+        if (used == perSlab) {
+            slabs.push_back(static_cast<char*>(::operator new(objSize * perSlab)));
+            used = 0;
+        }
+        return slabs.back() + objSize * used++;
+    }
+
+    // 黹һ󣨲
+    void deallocate(void* p) {
+        *static_cast<void**>(p) = freeList;
+        freeList = p;
+    }
+
+    // һԹ黹п
+    void releaseAll() {
+        for (char* s : slabs) ::operator delete(s);
+        slabs.clear();
+        used = perSlab;
+        freeList = nullptr;
+    }
+
+    // ϵͳֽ
+    size_t bytesReserved() const {
+        return slabs.size() * objSize * perSlab;
+    }
+};
@@ -0,0 +1,232 @@
+#include "Checksum.h"
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define CHECKSUM_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// GCC/Clang ҪΪʹ SSE2/AVX2 ָĺָĿ꣬MSVC Ҫ
+#if defined(CHECKSUM_X86) && defined(__GNUC__)
+#define CHECKSUM_TARGET_SSE2 __attribute__((target("sse2")))
+#define CHECKSUM_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define CHECKSUM_TARGET_SSE2
+#define CHECKSUM_TARGET_AVX2
+#endif
+
+namespace {
+
+// 64 λۼֵ۵ 16 λͣ2^16  1 (mod 0xFFFF)λֱӼӻصλ
+inline uint16_t Fold64(uint64_t s) {
+    s = (s & 0xFFFFFFFF) + (s >> 32);
+    s = (s & 0xFFFFFFFF) + (s >> 32);
+    s = (s & 0xFFFF) + (s >> 16);
+    s = (s & 0xFFFF) + (s >> 16);
+    s = (s & 0xFFFF) + (s >> 16);
+    return (uint16_t)s;
+}
+
+// һȵβsum ԶС 2^64
+inline uint64_t SumTail(const unsigned char* p, size_t len, uint64_t sum) {
+    while (len >= 4) {
+        uint32_t v;
+        memcpy(&v, p, 4);
+        sum += v;
+        p += 4;
+        len -= 4;
+    }
+    if (len >= 2) {
+        uint16_t v;
+        memcpy(&v, p, 2);
+        sum += v;
+        p += 2;
+        len -= 2;
+    }
+    if (len) {
+        uint16_t v = 0;     // ȣһֽڲ 0 ճһ 16 λ
+        memcpy(&v, p, 1);
+        sum += v;
+    }
+    return sum;
+}
+
+// ÿۼ 8 ֽڣλӻλ
+uint16_t ScalarKernel(const unsigned char* p, size_t len) {
+    uint64_t sum = 0;
+    while (len >= 8) {
+        uint64_t v;
+        memcpy(&v, p, 8);
+        sum += v;
+        sum += (sum < v);
+        p += 8;
+        len -= 8;
+    }
+    return Fold64(SumTail(p, len, Fold64(sum)));
+}
+
+#ifdef CHECKSUM_X86
+// SSE216 λչ 32 λͨۼӡÿ飨16 ֽڣÿͨ 16 λ֣
+// 32767 ֮ڲ֮ͨ鲢 64 λ
+CHECKSUM_TARGET_SSE2 uint16_t Sse2Kernel(const unsigned char* p, size_t len) {
+    const __m128i zero = _mm_setzero_si128();
+    uint64_t sum = 0;
+    while (len >= 16) {
+        size_t blocks = len / 16;
+        if (blocks > 32767) blocks = 32767;
+        len -= blocks * 16;
+
+        __m128i lo = zero, hi = zero;
+        for (; blocks >= 2; blocks -= 2, p += 32) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16));
+            lo = _mm_add_epi32(lo, _mm_add_epi32(_mm_unpacklo_epi16(a, zero), _mm_unpackhi_epi16(a, zero)));
+            hi = _mm_add_epi32(hi, _mm_add_epi32(_mm_unpacklo_epi16(b, zero), _mm_unpackhi_epi16(b, zero)));
+        }
+        if (blocks) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            lo = _mm_add_epi32(lo, _mm_add_epi32(_mm_unpacklo_epi16(a, zero), _mm_unpackhi_epi16(a, zero)));
+            p += 16;
+        }
+
+        __m128i t = _mm_add_epi64(_mm_unpacklo_epi32(lo, zero), _mm_unpackhi_epi32(lo, zero));
+        t = _mm_add_epi64(t, _mm_unpacklo_epi32(hi, zero));
+        t = _mm_add_epi64(t, _mm_unpackhi_epi32(hi, zero));
+        uint64_t parts[2];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(parts), t);
+        sum += parts[0] + parts[1];
+    }
+    return Fold64(SumTail(p, len, sum));
+}
+
+// AVX2ͬ SSE2һδ 32 ֽ
+CHECKSUM_TARGET_AVX2 uint16_t Avx2Kernel(const unsigned char* p, size_t len) {
+    const __m256i zero = _mm256_setzero_si256();
+    uint64_t sum = 0;
+    while (len >= 32) {
+        size_t blocks = len / 32;
+        if (blocks > 32767) blocks = 32767;
+        len -= blocks * 32;
+
+        __m256i lo = zero, hi = zero;
+        for (; blocks >= 2; blocks -= 2, p += 64) {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+            lo = _mm256_add_epi32(lo, _mm256_add_epi32(_mm256_unpacklo_epi16(a, zero), _mm256_unpackhi_epi16(a, zero)));
+            hi = _mm256_add_epi32(hi, _mm256_add_epi32(_mm256_unpacklo_epi16(b, zero), _mm256_unpackhi_epi16(b, zero)));
+        }
+        if (blocks) {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            lo = _mm256_add_epi32(lo, _mm256_add_epi32(_mm256_unpacklo_epi16(a, zero), _mm256_unpackhi_epi16(a, zero)));
+            p += 32;
+        }
+
+        __m256i t = _mm256_add_epi64(_mm256_unpacklo_epi32(lo, zero), _mm256_unpackhi_epi32(lo, zero));
+        t = _mm256_add_epi64(t, _mm256_unpacklo_epi32(hi, zero));
+        t = _mm256_add_epi64(t, _mm256_unpackhi_epi32(hi, zero));
+        uint64_t parts[4];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(parts), t);
+        sum += parts[0] + parts[1] + parts[2] + parts[3];
+    }
+    return Fold64(SumTail(p, len, sum));
+}
+#endif
+
+bool CpuHasSse2() {
+#if defined(_M_X64) || defined(__x86_64__)
+    return true;    // x64 Ȼ֧
+#elif defined(CHECKSUM_X86) && defined(_MSC_VER)
+    int r[4];
+    __cpuid(r, 1);
+    return (r[3] & (1 << 26)) != 0;
+#elif defined(CHECKSUM_X86)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2");
+#else
+    return false;
+#endif
+}
+
+bool CpuHasAvx2() {
+#if defined(CHECKSUM_X86) && defined(_MSC_VER)
+    int r[4];
+    __cpuid(r, 0);
+    if (r[0] < 7) return false;
+    __cpuid(r, 1);
+    bool osxsave = (r[2] & (1 << 27)) != 0;
+    bool avx = (r[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) return false;   // ϵͳ뱣 YMM Ĵ
+    __cpuidex(r, 7, 0);
+    return (r[1] & (1 << 5)) != 0;
+#elif defined(CHECKSUM_X86)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+typedef uint16_t (*Kernel)(const unsigned char*, size_t);
+
+struct Dispatch {
+    Kernel kernel;
+    const char* name;
+};
+
+Dispatch SelectKernel() {
+#ifdef CHECKSUM_X86
+    if (ChecksumHasAvx2()) return Dispatch{ Avx2Kernel, "AVX2" };
+    if (ChecksumHasSse2()) return Dispatch{ Sse2Kernel, "SSE2" };
+#endif
+    return Dispatch{ ScalarKernel, "" };
+}
+
+const Dispatch& CurrentKernel() {
+    static const Dispatch d = SelectKernel();
+    return d;
+}
+
+}
+
+uint16_t ChecksumAccumulate(const void* data, size_t len, uint16_t sum) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    // ͷĶֱñʡȥĴĹ鲢
+    uint16_t s = len < 128 ? ScalarKernel(p, len) : CurrentKernel().kernel(p, len);
+    return ChecksumCombine(sum, s);
+}
+
+uint16_t ChecksumScalar(const void* data, size_t len) {
+    return ScalarKernel(static_cast<const unsigned char*>(data), len);
+}
+
+uint16_t ChecksumSse2(const void* data, size_t len) {
+#ifdef CHECKSUM_X86
+    if (ChecksumHasSse2()) return Sse2Kernel(static_cast<const unsigned char*>(data), len);
+#endif
+    return ChecksumScalar(data, len);
+}
+
+uint16_t ChecksumAvx2(const void* data, size_t len) {
+#ifdef CHECKSUM_X86
+    if (ChecksumHasAvx2()) return Avx2Kernel(static_cast<const unsigned char*>(data), len);
+#endif
+    return ChecksumScalar(data, len);
+}
+
+// CPUID ֻܺһ
+bool ChecksumHasSse2() {
+    static const bool has = CpuHasSse2();
+    return has;
+}
+
+bool ChecksumHasAvx2() {
+    static const bool has = CpuHasAvx2();
+    return has;
+}
+
+const char* ChecksumKernelName() {
+    return CurrentKernel().name;
+}
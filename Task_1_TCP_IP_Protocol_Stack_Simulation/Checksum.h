@@ -0,0 +1,48 @@
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include <cstddef>
+#include <cstdint>
+
+// RFC 1071 Уͣ16 λͣ
+// ֽ޹أֽۼ 16 λֽ֡дأ
+// õľǱֽУֶΣ"ڴеԭ"⡣
+// ۼںбSSE2AVX2 ֣״εʱ CPU ֧ѡ
+
+// ۼ data е 16 λ֣۵ 16 λĲֺͣδȡ
+// sum ΪǰݵĲֺͣڷֶۼӣһγΪż
+uint16_t ChecksumAccumulate(const void* data, size_t len, uint16_t sum = 0);
+
+// ȡõУֶεֵ
+inline uint16_t ChecksumFinish(uint16_t sum) {
+    return (uint16_t)~sum;
+}
+
+inline uint16_t InternetChecksum(const void* data, size_t len) {
+    return ChecksumFinish(ChecksumAccumulate(data, len));
+}
+
+// ֺ͵ķӷ
+inline uint16_t ChecksumCombine(uint16_t a, uint16_t b) {
+    uint32_t s = (uint32_t)a + b;
+    return (uint16_t)((s & 0xFFFF) + (s >> 16));
+}
+
+// RFC 1624 £ĳ 16 λ oldWord Ϊ newWord ʱ
+// ԭУֱУͣHC' = ~(~HC + ~m + m')
+inline uint16_t ChecksumAdjust(uint16_t checksum, uint16_t oldWord, uint16_t newWord) {
+    uint16_t sum = ChecksumCombine(ChecksumCombine((uint16_t)~checksum, (uint16_t)~oldWord), newWord);
+    return ChecksumFinish(sum);
+}
+
+// ۼںˣ²Եãֵͬ ChecksumAccumulatesum ȡ 0
+uint16_t ChecksumScalar(const void* data, size_t len);
+uint16_t ChecksumSse2(const void* data, size_t len);
+uint16_t ChecksumAvx2(const void* data, size_t len);
+bool ChecksumHasSse2();
+bool ChecksumHasAvx2();
+
+// ǰѡõں
+const char* ChecksumKernelName();
+
+#endif
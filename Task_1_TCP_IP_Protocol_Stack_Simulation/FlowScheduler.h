@@ -0,0 +1,203 @@
+#ifndef FLOWSCHEDULER_H
+#define FLOWSCHEDULER_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "Packet.h"
+#include "PacketPool.h"
+using namespace std;
+
+// Ŷӵĵ
+// ÿԪ飩һ FIFOݰԾΪ±괮ӳӶڴ棻
+// ǿյ˳"Ծ"Уʱɾգ
+// ڴֻͬʱԾÿδĸԾȡ
+class FlowScheduler {
+protected:
+    static const uint32_t NONE = 0xFFFFFFFF;
+
+    struct Flow {
+        FlowKey key;
+        PacketHandle head;      // ݰ
+        PacketHandle tail;
+        uint32_t packets;
+        uint32_t nextActive;    // Ծеĺ
+        int64_t deficit;        // DRR ĳּֽڣ
+        bool granted;           // Ƿõ
+    };
+
+    vector<Flow> flows;                             // ±긴
+    vector<uint32_t> freeFlows;                     // е±
+    unordered_map<FlowKey, uint32_t, FlowKeyHash> index;    // Ԫ -> ±ֻ꣬ǿ
+    vector<PacketHandle> nextPacket;                // ԾΪ±꣺һݰ
+    vector<uint32_t> packetSize;                    // ԾΪ±꣺֡DRR ֽڼƷ
+    uint32_t activeHead;
+    uint32_t activeTail;
+    size_t queued;
+
+    void pushActive(uint32_t f) {
+        flows[f].nextActive = NONE;
+        if (activeTail == NONE) activeHead = f;
+        else flows[activeTail].nextActive = f;
+        activeTail = f;
+    }
+
+    uint32_t popActive() {
+        uint32_t f = activeHead;
+        activeHead = flows[f].nextActive;
+        if (activeHead == NONE) activeTail = NONE;
+        return f;
+    }
+
+    //  f ͷȡһݰ
+    PacketHandle popPacket(uint32_t f) {
+        Flow& flow = flows[f];
+        PacketHandle h = flow.head;
+        flow.head = nextPacket[h];
+        --flow.packets;
+        --queued;
+        return h;
+    }
+
+    // ѿգɾ±
+    void releaseFlow(uint32_t f) {
+        index.erase(flows[f].key);
+        freeFlows.push_back(f);
+    }
+
+public:
+    // packetCapacityȡֵΧݰشС
+    explicit FlowScheduler(size_t packetCapacity)
+        : nextPacket(packetCapacity), packetSize(packetCapacity), activeHead(NONE), activeTail(NONE), queued(0) {}
+
+    virtual ~FlowScheduler() {}
+
+    FlowScheduler(const FlowScheduler&) = delete;
+    FlowScheduler& operator=(const FlowScheduler&) = delete;
+
+    virtual const char* name() const = 0;
+
+    // ֡仯޸ MTUʱЭջãҪݴ˵ĵд
+    virtual void setMaxFrameSize(uint32_t) {}
+
+    // ݰ h֡ sizeŵĶβ O(1)
+    void enqueue(const FlowKey& key, PacketHandle h, uint32_t size) {
+        nextPacket[h] = NONE;
+        packetSize[h] = size;
+        ++queued;
+
+        auto it = index.find(key);
+        if (it != index.end()) {
+            Flow& flow = flows[it->second];
+            nextPacket[flow.tail] = h;
+            flow.tail = h;
+            ++flow.packets;
+            return;
+        }
+
+        uint32_t f;
+        if (!freeFlows.empty()) {
+            f = freeFlows.back();
+            freeFlows.pop_back();
+        }
+        else {
+            f = (uint32_t)flows.size();
+            flows.push_back(Flow());
+        }
+        Flow& flow = flows[f];
+        flow.key = key;
+        flow.head = flow.tail = h;
+        flow.packets = 1;
+        flow.deficit = 0;
+        flow.granted = false;
+        index.emplace(key, f);
+        pushActive(f);
+    }
+
+    // ȡһҪ͵ݰȫΪʱ false
+    virtual bool dequeue(PacketHandle& h) = 0;
+
+    size_t size() const {
+        return queued;
+    }
+
+    bool empty() const {
+        return queued == 0;
+    }
+
+    // ǰǿյ
+    size_t activeFlows() const {
+        return index.size();
+    }
+};
+
+// ѯԾθһ
+class RoundRobinScheduler : public FlowScheduler {
+public:
+    explicit RoundRobinScheduler(size_t packetCapacity) : FlowScheduler(packetCapacity) {}
+
+    const char* name() const override {
+        return "RR";
+    }
+
+    bool dequeue(PacketHandle& h) override {
+        if (activeHead == NONE) return false;
+        uint32_t f = popActive();
+        h = popPacket(f);
+        if (flows[f].packets) pushActive(f);
+        else releaseFlow(f);
+        return true;
+    }
+};
+
+// ѯDRRÿָ quantum ֽڵֽڶǰƽ
+// quantum С֡ʱÿγֻ賣
+class DrrScheduler : public FlowScheduler {
+private:
+    int64_t quantum;
+
+public:
+    DrrScheduler(size_t packetCapacity, uint32_t quantumBytes)
+        : FlowScheduler(packetCapacity), quantum(quantumBytes) {}
+
+    const char* name() const override {
+        return "DRR";
+    }
+
+    // ӸһλʱЧ
+    void setQuantum(uint32_t bytes) {
+        quantum = bytes;
+    }
+
+    // ֤֡ÿγǳ
+    void setMaxFrameSize(uint32_t bytes) override {
+        setQuantum(bytes);
+    }
+
+    bool dequeue(PacketHandle& h) override {
+        while (activeHead != NONE) {
+            uint32_t f = activeHead;
+            Flow& flow = flows[f];
+            if (!flow.granted) {
+                flow.deficit += quantum;
+                flow.granted = true;
+            }
+            if (packetSize[flow.head] <= flow.deficit) {
+                flow.deficit -= packetSize[flow.head];
+                h = popPacket(f);
+                if (!flow.packets) {
+                    popActive();
+                    releaseFlow(f);     // ʱ㣨һգ
+                }
+                return true;
+            }
+            // ͷİֽŵβ
+            flow.granted = false;
+            popActive();
+            pushActive(f);
+        }
+        return false;
+    }
+};
+
+#endif
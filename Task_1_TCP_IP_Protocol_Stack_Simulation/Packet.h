@@ -1,8 +1,11 @@
 #ifndef PACKET_H
 #define PACKET_H
 
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
 #include <string>
-#include <stack>
+#include <vector>
 using namespace std;
 
 // Э
@@ -13,30 +16,218 @@ enum LayerType {
     DATALINK
 };
 
-// ͷṹ
+// ֽ <-> ֽ򣨴ˣֽƴװ뱾ֽ޹
+inline uint16_t HostToNet16(uint16_t v) {
+    unsigned char b[2] = { (unsigned char)(v >> 8), (unsigned char)v };
+    uint16_t r;
+    memcpy(&r, b, 2);
+    return r;
+}
+
+inline uint32_t HostToNet32(uint32_t v) {
+    unsigned char b[4] = { (unsigned char)(v >> 24), (unsigned char)(v >> 16), (unsigned char)(v >> 8), (unsigned char)v };
+    uint32_t r;
+    memcpy(&r, b, 4);
+    return r;
+}
+
+inline uint16_t NetToHost16(uint16_t v) {
+    unsigned char b[2];
+    memcpy(b, &v, 2);
+    return (uint16_t)((b[0] << 8) | b[1]);
+}
+
+inline uint32_t NetToHost32(uint32_t v) {
+    unsigned char b[4];
+    memcpy(b, &v, 4);
+    return ((uint32_t)b[0] << 24) | ((uint32_t)b[1] << 16) | ((uint32_t)b[2] << 8) | b[3];
+}
+
+// ͷṹʵĸʽֶֽ֣һɴֽ
+#pragma pack(push, 1)
 struct AppHeader {
-    string appName = "MyApp";
+    char appName[8];        // Ӧ㲹 '\0'
+    uint16_t length;        // Ӧݳ
+    uint16_t reserved;
 };
 
 struct TcpHeader {
-    int srcPort = 12345;
-    int dstPort = 80;
+    uint16_t srcPort;
+    uint16_t dstPort;
+    uint32_t seq;
+    uint32_t ack;
+    uint8_t dataOffset;     //  4 λͷȣλ 4 ֽڣ
+    uint8_t flags;
+    uint16_t window;
+    uint16_t checksum;
+    uint16_t urgent;
 };
 
 struct IpHeader {
-    string srcIP = "192.168.1.10";
-    string dstIP = "192.168.1.100";
+    uint8_t versionIhl;     // 汾 4 + ͷ 5λ 4 ֽڣ
+    uint8_t tos;
+    uint16_t totalLength;   // IP ͷ + 
+    uint16_t id;
+    uint16_t fragment;      // ־λ + Ƭƫ
+    uint8_t ttl;
+    uint8_t protocol;       // 6 = TCP
+    uint16_t checksum;
+    uint32_t srcIP;
+    uint32_t dstIP;
+};
+
+//  TCP Уõαͷڱд䣩
+struct PseudoHeader {
+    uint32_t srcIP;
+    uint32_t dstIP;
+    uint8_t zero;
+    uint8_t protocol;
+    uint16_t tcpLength;     // TCP ͷ + 
 };
 
 struct MacHeader {
-    string srcMac = "AA:BB:CC:DD:EE:FF";
-    string dstMac = "11:22:33:44:55:66";
+    uint8_t dstMac[6];
+    uint8_t srcMac[6];
+    uint16_t etherType;     // 0x0800 = IPv4
+};
+#pragma pack(pop)
+
+static_assert(sizeof(AppHeader) == 12, "AppHeader ָı");
+static_assert(sizeof(TcpHeader) == 20, "TcpHeader ָı");
+static_assert(sizeof(IpHeader) == 20, "IpHeader ָı");
+static_assert(sizeof(MacHeader) == 14, "MacHeader ָı");
+static_assert(sizeof(PseudoHeader) == 12, "PseudoHeader ָı");
+
+const uint16_t ETHERTYPE_IPV4 = 0x0800;
+const uint8_t IP_PROTO_TCP = 6;
+const uint16_t IP_FLAG_DF = 0x4000;          // Ƭ
+const uint16_t IP_FLAG_MF = 0x2000;          // 滹зƬ
+const uint16_t IP_OFFSET_MASK = 0x1FFF;      // Ƭƫƣλ 8 ֽڣ
+const uint8_t TCP_FLAG_PSH = 0x08;
+const uint8_t TCP_FLAG_ACK = 0x10;
+
+// IP ֶܳΪ 16 λݰܳص
+const size_t MAX_PAYLOAD = 65535 - sizeof(IpHeader) - sizeof(TcpHeader) - sizeof(AppHeader);
+
+// Ĭ MTU̫ IPv4 涨С MTU
+const size_t DEFAULT_MTU = 1500;
+const size_t MIN_MTU = 68;
+
+// Ĭϵַ˿
+const char DEFAULT_APP_NAME[] = "MyApp";
+const uint16_t DEFAULT_SRC_PORT = 12345;
+const uint16_t DEFAULT_DST_PORT = 80;
+const uint32_t DEFAULT_SRC_IP = 0xC0A8010A;    // 192.168.1.10
+const uint32_t DEFAULT_DST_IP = 0xC0A80164;    // 192.168.1.100
+const uint8_t DEFAULT_SRC_MAC[6] = { 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF };
+const uint8_t DEFAULT_DST_MAC[6] = { 0x11, 0x22, 0x33, 0x44, 0x55, 0x66 };
+
+// ʶԪ飨ֽ
+struct FlowKey {
+    uint32_t srcIP;
+    uint32_t dstIP;
+    uint16_t srcPort;
+    uint16_t dstPort;
+    uint8_t protocol;
+
+    bool operator==(const FlowKey& o) const {
+        return srcIP == o.srcIP && dstIP == o.dstIP && srcPort == o.srcPort && dstPort == o.dstPort && protocol == o.protocol;
+    }
+};
+
+// Ԫϣƴ 64 λ 64 λϣmurmur3 fmix64
+struct FlowKeyHash {
+    size_t operator()(const FlowKey& k) const {
+        uint64_t a = ((uint64_t)k.srcIP << 32) | k.dstIP;
+        uint64_t b = ((uint64_t)k.srcPort << 24) | ((uint64_t)k.dstPort << 8) | k.protocol;
+        uint64_t h = a ^ (b * 0x9E3779B97F4A7C15ULL);
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDULL;
+        h ^= h >> 33;
+        h *= 0xC4CEB9FE1A85EC53ULL;
+        h ^= h >> 33;
+        return (size_t)h;
+    }
 };
 
-// Packet ݰ
+const FlowKey DEFAULT_FLOW = { DEFAULT_SRC_IP, DEFAULT_DST_IP, DEFAULT_SRC_PORT, DEFAULT_DST_PORT, IP_PROTO_TCP };
+
+// ֽ IPv4 ַʽΪʮ
+inline string FormatIP(uint32_t ip) {
+    char s[16];
+    snprintf(s, sizeof(s), "%u.%u.%u.%u", (ip >> 24) & 0xFF, (ip >> 16) & 0xFF, (ip >> 8) & 0xFF, ip & 0xFF);
+    return s;
+}
+
+inline string FormatHex16(uint16_t v) {
+    char s[7];
+    snprintf(s, sizeof(s), "0x%04X", v);
+    return s;
+}
+
+inline string FormatMac(const uint8_t* mac) {
+    char s[18];
+    snprintf(s, sizeof(s), "%02X:%02X:%02X:%02X:%02X:%02X", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+    return s;
+}
+
+// Packet ݰһǰԤ HEADROOM ֽ
+// װʱͷдڵǰ֮ǰǰƣװʱưͷ
+// ̲ƸءΪͷڴ
 struct Packet {
-    string payload;               // ԭʼ
-    stack<string> headerStack;    // ģЭջ
+    static const size_t HEADROOM = 128;   // 㹻 MAC + IP + TCP + App ͷ
+
+    vector<unsigned char> buffer;
+    size_t head;    // ǰ buffer еƫ
+    size_t len;     // ǰݳȣѹͷ
+
+    Packet() : head(HEADROOM), len(0) {}
+
+    // װԭʼݣл㹻ʱֱӸ
+    void assign(const void* payload, size_t n) {
+        if (buffer.size() < HEADROOM + n) buffer.resize(HEADROOM + n);
+        memcpy(buffer.data() + HEADROOM, payload, n);
+        head = HEADROOM;
+        len = n;
+    }
+
+    void assign(const string& payload) {
+        assign(payload.data(), payload.size());
+    }
+
+    unsigned char* data() {
+        return buffer.data() + head;
+    }
+
+    const unsigned char* data() const {
+        return buffer.data() + head;
+    }
+
+    size_t size() const {
+        return len;
+    }
+
+    // ֻǰ n ֽ
+    void truncate(size_t n) {
+        if (n < len) len = n;
+    }
+
+    // ǰԤ n ֽڲַдͷԤռ䲻ʱ nullptr
+    void* push(size_t n) {
+        if (n > head) return nullptr;
+        head -= n;
+        len += n;
+        return buffer.data() + head;
+    }
+
+    // ǰ˰ n ֽڲԭַݲʱ nullptr
+    const void* pull(size_t n) {
+        if (n > len) return nullptr;
+        const unsigned char* p = buffer.data() + head;
+        head += n;
+        len -= n;
+        return p;
+    }
 };
 
 #endif
@@ -0,0 +1,67 @@
+#ifndef PACKETPOOL_H
+#define PACKETPOOL_H
+
+#include <cstdint>
+#include <vector>
+#include "Packet.h"
+#include "SpscRing.h"
+using namespace std;
+
+// ݰе±
+typedef uint32_t PacketHandle;
+
+// Ԥݰ
+//  Packet ڹʱһνòԤֻ֮֮߳䴫ݾ
+// оһ SPSC ߳ acquire߳ release
+// һ߳ + һ߳̿عһء
+// ߳ȡûܷݰ recycle ŻԼıػ棬 release
+class PacketPool {
+private:
+    vector<Packet> packets;
+    SpscRing<PacketHandle> freeRing;
+    vector<PacketHandle> senderCache;   // ֻɷ̷߳
+
+public:
+    // count ݰÿԤ HEADROOM + bufferSize ֽ
+    PacketPool(size_t count, size_t bufferSize) : packets(count), freeRing(count) {
+        senderCache.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            packets[i].buffer.resize(Packet::HEADROOM + bufferSize);
+            freeRing.push((PacketHandle)i);
+        }
+    }
+
+    PacketPool(const PacketPool&) = delete;
+    PacketPool& operator=(const PacketPool&) = delete;
+
+    // ȡһݰ̵߳ãñػ棬þʱ false
+    bool acquire(PacketHandle& h) {
+        if (!senderCache.empty()) {
+            h = senderCache.back();
+            senderCache.pop_back();
+            return true;
+        }
+        return freeRing.pop(h);
+    }
+
+    // ̹߳黹ȡδݰԼ´ acquire
+    // лֻн߳һߣ̲߳
+    void recycle(PacketHandle h) {
+        senderCache.push_back(h);
+    }
+
+    // 黹ݰ̵߳ã´ʹ
+    void release(PacketHandle h) {
+        freeRing.push(h);
+    }
+
+    Packet& operator[](PacketHandle h) {
+        return packets[h];
+    }
+
+    size_t size() const {
+        return packets.size();
+    }
+};
+
+#endif
@@ -0,0 +1,85 @@
+#include "Pcap.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+bool PcapReader::open(const string& path) {
+    close();
+#ifdef _WIN32
+    HANDLE f = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (f == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER sz;
+    if (!GetFileSizeEx(f, &sz) || sz.QuadPart < (LONGLONG)sizeof(PcapFileHeader)) {
+        CloseHandle(f);
+        return false;
+    }
+    HANDLE m = CreateFileMappingA(f, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m) {
+        CloseHandle(f);
+        return false;
+    }
+    void* p = MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0);
+    if (!p) {
+        CloseHandle(m);
+        CloseHandle(f);
+        return false;
+    }
+    fileHandle = f;
+    mapping = m;
+    fileSize = (size_t)sz.QuadPart;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(PcapFileHeader)) {
+        ::close(fd);
+        return false;
+    }
+    void* p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);    // ӳ佨󼴿ɹر
+    if (p == MAP_FAILED) return false;
+    madvise(p, (size_t)st.st_size, MADV_SEQUENTIAL);
+    mapping = p;
+    fileSize = (size_t)st.st_size;
+#endif
+    base = static_cast<const unsigned char*>(p);
+
+    PcapFileHeader h;
+    memcpy(&h, base, sizeof(h));
+    if (h.magic == PCAP_MAGIC_USEC || h.magic == PCAP_MAGIC_NSEC) swapped = false;
+    else if (h.magic == 0xD4C3B2A1 || h.magic == 0x4D3CB2A1) swapped = true;
+    else {
+        close();
+        return false;
+    }
+    linkType = field(h.linkType);
+    offset = sizeof(PcapFileHeader);
+    return true;
+}
+
+void PcapReader::close() {
+    if (!base) return;
+#ifdef _WIN32
+    UnmapViewOfFile(base);
+    CloseHandle(mapping);
+    CloseHandle(fileHandle);
+#else
+    munmap(mapping, fileSize);
+#endif
+    base = nullptr;
+    mapping = nullptr;
+    fileHandle = nullptr;
+    fileSize = 0;
+    offset = 0;
+    swapped = false;
+    linkType = 0;
+}
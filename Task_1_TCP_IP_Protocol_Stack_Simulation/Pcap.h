@@ -0,0 +1,171 @@
+#ifndef PCAP_H
+#define PCAP_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+using namespace std;
+
+// libpcap ļʽhttps://wiki.wireshark.org/Development/LibpcapFileFormat
+// ļͷ֮һ"¼ͷ + ֡"ֶֽΰд뷽ıֽţȡħж
+#pragma pack(push, 1)
+struct PcapFileHeader {
+    uint32_t magic;         // 0xA1B2C3D4΢ʱ 0xA1B23C4Dʱ
+    uint16_t versionMajor;  // 2
+    uint16_t versionMinor;  // 4
+    int32_t thisZone;
+    uint32_t sigFigs;
+    uint32_t snapLen;       // ÿ֡ౣֽ
+    uint32_t linkType;      // 1 = ̫
+};
+
+struct PcapRecordHeader {
+    uint32_t tsSec;
+    uint32_t tsFrac;        // ΢
+    uint32_t inclLen;       // ļбֽ
+    uint32_t origLen;       // ֡ʵʳ
+};
+#pragma pack(pop)
+
+static_assert(sizeof(PcapFileHeader) == 24, "PcapFileHeader ָı");
+static_assert(sizeof(PcapRecordHeader) == 16, "PcapRecordHeader ָı");
+
+const uint32_t PCAP_MAGIC_USEC = 0xA1B2C3D4;
+const uint32_t PCAP_MAGIC_NSEC = 0xA1B23C4D;
+const uint32_t PCAP_LINKTYPE_ETHERNET = 1;
+const uint32_t PCAP_SNAPLEN = 262144;           //  tcpdump Ĭֵܷͬ IP ݱ
+
+// ʽ pcap д룺֡׷ӵڴ滺һдļ
+class PcapWriter {
+private:
+    ofstream file;
+    vector<char> buf;
+    size_t len;
+    uint64_t frames;
+
+    void append(const void* p, size_t n) {
+        if (len + n > buf.size()) {
+            flush();
+            if (n > buf.size()) {   // Ȼֱд
+                file.write(static_cast<const char*>(p), (streamsize)n);
+                return;
+            }
+        }
+        memcpy(buf.data() + len, p, n);
+        len += n;
+    }
+
+public:
+    explicit PcapWriter(size_t capacity = 1 << 20) : buf(capacity), len(0), frames(0) {}
+
+    PcapWriter(const PcapWriter&) = delete;
+    PcapWriter& operator=(const PcapWriter&) = delete;
+
+    ~PcapWriter() {
+        close();
+    }
+
+    // ǣļдļͷ
+    bool open(const string& path) {
+        close();
+        file.open(path, ios::binary | ios::trunc);
+        if (!file) return false;
+        PcapFileHeader h = { PCAP_MAGIC_USEC, 2, 4, 0, 0, PCAP_SNAPLEN, PCAP_LINKTYPE_ETHERNET };
+        append(&h, sizeof(h));
+        frames = 0;
+        return true;
+    }
+
+    bool isOpen() const {
+        return file.is_open();
+    }
+
+    // ׷һ֡ʱȡǰʱ
+    void write(const void* frame, size_t n) {
+        auto us = chrono::duration_cast<chrono::microseconds>(chrono::system_clock::now().time_since_epoch()).count();
+        uint32_t incl = n < PCAP_SNAPLEN ? (uint32_t)n : PCAP_SNAPLEN;
+        PcapRecordHeader r = { (uint32_t)(us / 1000000), (uint32_t)(us % 1000000), incl, (uint32_t)n };
+        append(&r, sizeof(r));
+        append(frame, incl);
+        ++frames;
+    }
+
+    void flush() {
+        if (len) file.write(buf.data(), (streamsize)len);
+        len = 0;
+        file.flush();
+    }
+
+    void close() {
+        if (!file.is_open()) return;
+        flush();
+        file.close();
+    }
+
+    uint64_t frameCount() const {
+        return frames;
+    }
+};
+
+// pcap ȡļӳ䵽ڴ棬next صֱָ֡ӳơڴ档
+// ָ֡һ open/close ֮ǰЧ
+class PcapReader {
+private:
+    const unsigned char* base;
+    size_t fileSize;
+    size_t offset;
+    bool swapped;           // ļֽ뱾෴
+    uint32_t linkType;
+    void* mapping;          // ƽ̨صӳ
+    void* fileHandle;
+
+    uint32_t field(uint32_t v) const {
+        if (!swapped) return v;
+        return (v >> 24) | ((v >> 8) & 0xFF00) | ((v << 8) & 0xFF0000) | (v << 24);
+    }
+
+public:
+    PcapReader() : base(nullptr), fileSize(0), offset(0), swapped(false), linkType(0), mapping(nullptr), fileHandle(nullptr) {}
+
+    PcapReader(const PcapReader&) = delete;
+    PcapReader& operator=(const PcapReader&) = delete;
+
+    ~PcapReader() {
+        close();
+    }
+
+    // ӳļļͷ pcap ļʱ false
+    bool open(const string& path);
+    void close();
+
+    // ȡһ֡ļβضϵļ¼ʱ false
+    bool next(const unsigned char*& frame, uint32_t& n) {
+        if (offset + sizeof(PcapRecordHeader) > fileSize) return false;
+        PcapRecordHeader r;
+        memcpy(&r, base + offset, sizeof(r));
+        uint32_t incl = field(r.inclLen);
+        if (incl > fileSize - offset - sizeof(r)) return false;
+        frame = base + offset + sizeof(r);
+        n = incl;
+        offset += sizeof(r) + incl;
+        return true;
+    }
+
+    // صһ֡
+    void rewind() {
+        offset = base ? sizeof(PcapFileHeader) : 0;
+    }
+
+    uint32_t getLinkType() const {
+        return linkType;
+    }
+
+    size_t size() const {
+        return fileSize;
+    }
+};
+
+#endif
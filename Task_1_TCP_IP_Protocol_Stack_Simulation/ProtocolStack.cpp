@@ -1,64 +1,428 @@
 #include "ProtocolStack.h"
 #include <iostream>
+#include <cstring>
 using namespace std;
 
-// ------------------ װ ------------------
-void ProtocolStack::encapsulate(Packet& pkt) {
-    cout << "ʼװݰ..." << endl;
+// IP ͷиݰֶͬΣܳȡʶƬַУ 0
+static void InitIpHeader(IpHeader& ip) {
+    ip.versionIhl = 0x40 | (sizeof(IpHeader) / 4);
+    ip.tos = 0;
+    ip.totalLength = 0;
+    ip.id = 0;
+    ip.fragment = 0;
+    ip.ttl = 64;
+    ip.protocol = IP_PROTO_TCP;
+    ip.checksum = 0;
+    ip.srcIP = 0;
+    ip.dstIP = 0;
+}
+
+ProtocolStack::ProtocolStack(size_t capacity)
+    : pool(capacity, PACKET_BUFFER), sendQueue(capacity),
+    scheduler(new DrrScheduler(capacity, (uint32_t)(mtu + sizeof(MacHeader))))
+{
+    // ݰ IP ͷֻܳȡʶƬֶַβͬ
+    // ЩֶΪ 0 ʱУͣʱ RFC 1624 
+    IpHeader base;
+    InitIpHeader(base);
+    ipBaseChecksum = InternetChecksum(&base, sizeof(base));
+}
+
+// TCP У͸ǵ αͷ + TCP ͷ +  ĲֺͣδȡַΪֽ
+static uint16_t TcpChecksumSum(uint32_t srcIP, uint32_t dstIP, const unsigned char* segment, size_t len) {
+    PseudoHeader ph;
+    ph.srcIP = srcIP;
+    ph.dstIP = dstIP;
+    ph.zero = 0;
+    ph.protocol = IP_PROTO_TCP;
+    ph.tcpLength = HostToNet16((uint16_t)len);
+    return ChecksumAccumulate(segment, len, ChecksumAccumulate(&ph, sizeof(ph)));
+}
+
+// ------------------ ͷ ------------------
+void ProtocolStack::pushAppHeader(Packet& pkt) {
+    size_t payloadLen = pkt.size();
+    AppHeader* app = static_cast<AppHeader*>(pkt.push(sizeof(AppHeader)));
+    *app = AppHeader();
+    memcpy(app->appName, DEFAULT_APP_NAME, sizeof(DEFAULT_APP_NAME));
+    app->length = HostToNet16((uint16_t)payloadLen);
+}
+
+void ProtocolStack::pushTcpHeader(Packet& pkt, const FlowKey& flow) {
+    size_t segmentLen = pkt.size();
+    TcpHeader* tcp = static_cast<TcpHeader*>(pkt.push(sizeof(TcpHeader)));
+    tcp->srcPort = HostToNet16(flow.srcPort);
+    tcp->dstPort = HostToNet16(flow.dstPort);
+    tcp->seq = HostToNet32(nextSeq);
+    tcp->ack = 0;
+    tcp->dataOffset = (sizeof(TcpHeader) / 4) << 4;
+    tcp->flags = TCP_FLAG_PSH | TCP_FLAG_ACK;
+    tcp->window = HostToNet16(65535);
+    tcp->checksum = 0;
+    tcp->urgent = 0;
+    nextSeq += (uint32_t)segmentLen;
+    tcp->checksum = ChecksumFinish(TcpChecksumSum(HostToNet32(flow.srcIP), HostToNet32(flow.dstIP),
+        pkt.data(), pkt.size()));
+}
+
+void ProtocolStack::pushIpHeader(Packet& pkt, const FlowKey& flow, uint16_t id, uint16_t fragment) {
+    IpHeader* ip = static_cast<IpHeader*>(pkt.push(sizeof(IpHeader)));
+    InitIpHeader(*ip);
+    ip->totalLength = HostToNet16((uint16_t)pkt.size());
+    ip->id = HostToNet16(id);
+    ip->fragment = HostToNet16(fragment);
+    ip->srcIP = HostToNet32(flow.srcIP);
+    ip->dstIP = HostToNet32(flow.dstIP);
+
+    // ڻ׼УβɱֶΣԭֵΪ 0
+    uint16_t c = ChecksumAdjust(ipBaseChecksum, 0, ip->totalLength);
+    c = ChecksumAdjust(c, 0, ip->id);
+    c = ChecksumAdjust(c, 0, ip->fragment);
+    uint16_t addr[4];
+    memcpy(addr, &ip->srcIP, sizeof(addr));
+    for (uint16_t w : addr) c = ChecksumAdjust(c, 0, w);
+    ip->checksum = c;
+}
+
+void ProtocolStack::pushMacHeader(Packet& pkt) {
+    MacHeader* mac = static_cast<MacHeader*>(pkt.push(sizeof(MacHeader)));
+    memcpy(mac->dstMac, DEFAULT_DST_MAC, 6);
+    memcpy(mac->srcMac, DEFAULT_SRC_MAC, 6);
+    mac->etherType = HostToNet16(ETHERTYPE_IPV4);
+}
+
+// 벢Уͷʽʱ nullptr
+const MacHeader* ProtocolStack::pullMacHeader(Packet& pkt) {
+    const MacHeader* mac = static_cast<const MacHeader*>(pkt.pull(sizeof(MacHeader)));
+    if (!mac || NetToHost16(mac->etherType) != ETHERTYPE_IPV4) return nullptr;
+    return mac;
+}
+
+const IpHeader* ProtocolStack::pullIpHeader(Packet& pkt) {
+    const IpHeader* ip = static_cast<const IpHeader*>(pkt.pull(sizeof(IpHeader)));
+    if (!ip || ip->versionIhl != (0x40 | (sizeof(IpHeader) / 4)) || ip->protocol != IP_PROTO_TCP ||
+        NetToHost16(ip->totalLength) != pkt.size() + sizeof(IpHeader)) return nullptr;
+    if (ChecksumAccumulate(ip, sizeof(IpHeader)) != 0xFFFF) return nullptr;   // УֶڵķӦΪȫ 1
+    return ip;
+}
+
+const TcpHeader* ProtocolStack::pullTcpHeader(Packet& pkt, const IpHeader* ip) {
+    if (TcpChecksumSum(ip->srcIP, ip->dstIP, pkt.data(), pkt.size()) != 0xFFFF) return nullptr;
+    const TcpHeader* tcp = static_cast<const TcpHeader*>(pkt.pull(sizeof(TcpHeader)));
+    if (!tcp || (tcp->dataOffset >> 4) != sizeof(TcpHeader) / 4) return nullptr;
+    return tcp;
+}
 
-    AppHeader app;
-    pkt.headerStack.push("[Application Header] App=" + app.appName);
+const AppHeader* ProtocolStack::pullAppHeader(Packet& pkt) {
+    const AppHeader* app = static_cast<const AppHeader*>(pkt.pull(sizeof(AppHeader)));
+    if (!app || NetToHost16(app->length) != pkt.size()) return nullptr;
+    return app;
+}
 
-    TcpHeader tcp;
-    pkt.headerStack.push("[TCP Header] SrcPort=" + to_string(tcp.srcPort)
-        + " DstPort=" + to_string(tcp.dstPort));
+// ------------------ Ƭ ------------------
+bool ProtocolStack::fragment(PacketHandle h, vector<Fragment>& out) {
+    uint16_t id = nextIpId++;
+    Packet& seg = pool[h];
+    size_t total = seg.size();
+    size_t chunk = (mtu - sizeof(IpHeader)) / 8 * 8;    // һƬ⣬Ƭ 8 ı
+    if (total <= mtu - sizeof(IpHeader)) {
+        out.push_back(Fragment{ h, id, 0 });
+        return true;
+    }
 
-    IpHeader ip;
-    pkt.headerStack.push("[IP Header] Src=" + ip.srcIP +
-        " Dst=" + ip.dstIP);
+    size_t first = out.size();
+    out.push_back(Fragment{ h, id, IP_FLAG_MF });
+    for (size_t offset = chunk; offset < total; offset += chunk) {
+        PacketHandle f;
+        if (!pool.acquire(f)) {
+            for (size_t i = first + 1; i < out.size(); ++i) pool.recycle(out[i].handle);
+            out.resize(first);
+            return false;
+        }
+        size_t n = min(chunk, total - offset);
+        pool[f].assign(seg.data() + offset, n);
+        uint16_t flags = offset + n < total ? IP_FLAG_MF : 0;
+        out.push_back(Fragment{ f, id, (uint16_t)(flags | (offset / 8)) });
+    }
+    seg.truncate(chunk);
+    return true;
+}
 
-    MacHeader mac;
-    pkt.headerStack.push("[MAC Header] Src=" + mac.srcMac +
-        " Dst=" + mac.dstMac);
+int ProtocolStack::reassemble(const IpHeader* ip, Packet& pkt) {
+    return reassembler.add(ip, pkt.data(), pkt.size());
+}
 
-    cout << "װɣѹ " << pkt.headerStack.size() << " ͷ\n";
+// ------------------ װ ------------------
+// ڸǰд App / TCP / IP / MAC ͷ
+void ProtocolStack::encapsulate(Packet& pkt) {
+    if (verbose) cout << "ʼװݰ..." << endl;
+
+    pushAppHeader(pkt);
+    pushTcpHeader(pkt, DEFAULT_FLOW);
+    pushIpHeader(pkt, DEFAULT_FLOW, nextIpId++, 0);
+    pushMacHeader(pkt);
+
+    if (verbose) cout << "װɣѹ 4 ͷ֡ " << pkt.size() << " ֽڣ\n";
 }
 
 // ------------------ װ ------------------
-void ProtocolStack::decapsulate(Packet pkt) {
-    cout << "\n---- װ START ----\n";
+// У鲢ͷֻƶ㣻ʽʱ false
+bool ProtocolStack::decapsulate(Packet& pkt) {
+    if (verbose) cout << "\n---- װ START ----\n";
 
-    while (!pkt.headerStack.empty()) {
-        cout << "ͷ " << pkt.headerStack.top() << endl;
-        pkt.headerStack.pop();
+    const MacHeader* mac = pullMacHeader(pkt);
+    if (!mac) {
+        if (verbose) cout << "ݰʽMAC ͷЧ\n";
+        return false;
     }
+    if (verbose) cout << "ͷ [MAC Header] Src=" << FormatMac(mac->srcMac) << " Dst=" << FormatMac(mac->dstMac) << endl;
 
-    cout << "յõ Payload " << pkt.payload << endl;
-    cout << "---- װ END ----\n" << endl;
+    const IpHeader* ip = pullIpHeader(pkt);
+    if (!ip) {
+        if (verbose) cout << "ݰʽIP ͷЧУʹ\n";
+        return false;
+    }
+    if (verbose) cout << "ͷ [IP Header] Src=" << FormatIP(NetToHost32(ip->srcIP))
+        << " Dst=" << FormatIP(NetToHost32(ip->dstIP)) << " Checksum=" << FormatHex16(NetToHost16(ip->checksum)) << endl;
+
+    uint16_t frag = NetToHost16(ip->fragment);
+    if ((frag & (IP_FLAG_MF | IP_OFFSET_MASK)) == 0) return decapsulateSegment(pkt, ip);
+
+    int slot = reassemble(ip, pkt);
+    if (slot == Reassembler::DROPPED) {
+        if (verbose) cout << "ݰʽIP ƬЧ\n";
+        return false;
+    }
+    if (slot == Reassembler::PENDING) {
+        if (verbose) {
+            cout << "յ IP Ƭʶ " << NetToHost16(ip->id) << "ƫ " << (frag & IP_OFFSET_MASK) * 8
+                << "" << pkt.size() << " ֽڣȴƬ\n";
+            cout << "---- װ END ----\n" << endl;
+        }
+        return true;
+    }
+    Packet& seg = reassembler.packet(slot);
+    if (verbose) cout << "IP Ƭɣ " << seg.size() << " ֽ\n";
+    bool ok = decapsulateSegment(seg, ip);
+    reassembler.release(slot);
+    return ok;
+}
+
+// 봫Ӧòͷ
+bool ProtocolStack::decapsulateSegment(Packet& seg, const IpHeader* ip) {
+    const TcpHeader* tcp = pullTcpHeader(seg, ip);
+    if (!tcp) {
+        if (verbose) cout << "ݰʽTCP ͷЧУʹ\n";
+        return false;
+    }
+    if (verbose) cout << "ͷ [TCP Header] SrcPort=" << NetToHost16(tcp->srcPort)
+        << " DstPort=" << NetToHost16(tcp->dstPort) << " Checksum=" << FormatHex16(NetToHost16(tcp->checksum)) << endl;
+
+    const AppHeader* app = pullAppHeader(seg);
+    if (!app) {
+        if (verbose) cout << "ݰʽӦòͷЧ\n";
+        return false;
+    }
+    if (verbose) {
+        cout << "ͷ [Application Header] App="
+            << string(app->appName, strnlen(app->appName, sizeof(app->appName))) << endl;
+        cout << "յõ Payload " << string((const char*)seg.data(), seg.size()) << endl;
+        cout << "---- װ END ----\n" << endl;
+    }
+    return true;
 }
 
 // ------------------ ģⷢ ------------------
+bool ProtocolStack::encapsulateDatagram(const FlowKey& flow, const string& data) {
+    if (data.size() > MAX_PAYLOAD) {
+        if (verbose) cout << "ݹ " << MAX_PAYLOAD << " ֽڣδ͡\n\n";
+        return false;
+    }
+
+    PacketHandle h;
+    if (!pool.acquire(h)) {
+        if (verbose) cout << "Ͷδ͡\n\n";
+        return false;
+    }
+    Packet& pkt = pool[h];
+    pkt.assign(data);
+
+    if (verbose) cout << "ʼװݰ..." << endl;
+    pushAppHeader(pkt);
+    pushTcpHeader(pkt, flow);
+
+    txFragments.clear();
+    if (!fragment(h, txFragments)) {
+        pool.recycle(h);
+        if (verbose) cout << "ݰزȫƬδ͡\n\n";
+        return false;
+    }
+    for (const Fragment& f : txFragments) {
+        pushIpHeader(pool[f.handle], flow, f.id, f.fragment);
+        pushMacHeader(pool[f.handle]);
+    }
+
+    if (verbose) {
+        if (txFragments.size() == 1) cout << "װɣѹ 4 ͷ֡ " << pkt.size() << " ֽڣ\n";
+        else cout << "װɣ MTU " << mtu << " Ϊ " << txFragments.size() << "  IP Ƭ\n";
+    }
+    return true;
+}
+
 void ProtocolStack::sendData(const string& data) {
-    Packet pkt;
-    pkt.payload = data;
+    if (!encapsulateDatagram(DEFAULT_FLOW, data)) return;
+    for (const Fragment& f : txFragments) queueFrame(f.handle);
+    if (verbose) cout << "ݰѼ뷢ͶУгȣ" << sendQueue.size() << "\n\n";
+}
+
+// ------------------  ------------------
+bool ProtocolStack::sendFlow(const FlowKey& flow, const string& data) {
+    if (!encapsulateDatagram(flow, data)) return false;
+    for (const Fragment& f : txFragments) scheduler->enqueue(flow, f.handle, (uint32_t)pool[f.handle].size());
+    if (verbose) cout << "ݰѼУԾ " << scheduler->activeFlows() << " \n\n";
+    return true;
+}
+
+size_t ProtocolStack::transmit(size_t n) {
+    size_t moved = 0;
+    PacketHandle h;
+    while (moved < n && scheduler->dequeue(h)) {
+        queueFrame(h);
+        ++moved;
+    }
+    return moved;
+}
 
-    encapsulate(pkt);
+bool ProtocolStack::setScheduler(unique_ptr<FlowScheduler> s) {
+    if (!scheduler->empty()) return false;
+    scheduler = move(s);
+    scheduler->setMaxFrameSize((uint32_t)(mtu + sizeof(MacHeader)));
+    return true;
+}
 
-    sendQueue.push(pkt);
-    cout << "ݰѼ뷢ͶУгȣ" << sendQueue.size() << "\n\n";
+void ProtocolStack::setMtu(size_t value) {
+    mtu = value < MIN_MTU ? MIN_MTU : value;
+    scheduler->setMaxFrameSize((uint32_t)(mtu + sizeof(MacHeader)));
+}
+
+void ProtocolStack::queueFrame(PacketHandle h) {
+    if (capture) capture->write(pool[h].data(), pool[h].size());
+    sendQueue.push(h);
 }
 
 // ------------------ ģ ------------------
 void ProtocolStack::receiveData() {
-    if (sendQueue.empty()) {
-        cout << "ͶΪգݿɽա\n\n";
+    PacketHandle h;
+    if (!sendQueue.pop(h)) {
+        if (verbose) cout << "ͶΪգݿɽա\n\n";
         return;
     }
 
-    Packet pkt = sendQueue.front();
-    sendQueue.pop();
+    if (verbose) cout << "֡ӷͶгӣʣࣺ" << sendQueue.size() << "\n";
 
-    cout << "ݰӷͶгӣʣࣺ" << sendQueue.size() << "\n";
+    decapsulate(pool[h]);
+    pool.release(h);
+}
 
-    decapsulate(pkt);
+// ------------------  ------------------
+size_t ProtocolStack::sendBatch(span<const string> payloads) {
+    txBatch.clear();
+    for (const string& data : payloads) {
+        if (data.size() > MAX_PAYLOAD) continue;
+        PacketHandle h;
+        if (!pool.acquire(h)) break;
+        pool[h].assign(data);
+        txBatch.push_back(h);
+    }
+
+    // 㴦ͬһĴͳݰʹ
+    for (PacketHandle h : txBatch) pushAppHeader(pool[h]);
+    for (PacketHandle h : txBatch) pushTcpHeader(pool[h], DEFAULT_FLOW);
+
+    txFragments.clear();
+    size_t sent = 0;
+    for (; sent < txBatch.size(); ++sent) {
+        if (!fragment(txBatch[sent], txFragments)) break;
+    }
+    for (size_t i = sent; i < txBatch.size(); ++i) pool.recycle(txBatch[i]);
+
+    for (const Fragment& f : txFragments) pushIpHeader(pool[f.handle], DEFAULT_FLOW, f.id, f.fragment);
+    for (const Fragment& f : txFragments) pushMacHeader(pool[f.handle]);
+
+    for (const Fragment& f : txFragments) queueFrame(f.handle);
+    return sent;
+}
+
+// ------------------  ------------------
+//  rxSegments лܵĶ봫Ӧòͷظʽȷĸ
+size_t ProtocolStack::deliverSegments(vector<string>* out) {
+    size_t segments = rxSegments.size();
+    rxSegmentOk.assign(segments, 1);
+    for (size_t i = 0; i < segments; ++i)
+        if (!pullTcpHeader(*rxSegments[i].pkt, rxSegments[i].ip)) rxSegmentOk[i] = 0;
+    for (size_t i = 0; i < segments; ++i)
+        if (rxSegmentOk[i] && !pullAppHeader(*rxSegments[i].pkt)) rxSegmentOk[i] = 0;
+
+    size_t good = 0;
+    for (size_t i = 0; i < segments; ++i) {
+        if (!rxSegmentOk[i]) continue;
+        ++good;
+        if (out) out->emplace_back((const char*)rxSegments[i].pkt->data(), rxSegments[i].pkt->size());
+    }
+    rxSegments.clear();
+    return good;
+}
+
+size_t ProtocolStack::receiveBatch(size_t n, vector<string>* out) {
+    rxBatch.clear();
+    PacketHandle h;
+    while (rxBatch.size() < n && sendQueue.pop(h)) rxBatch.push_back(h);
+
+    size_t count = rxBatch.size();
+    rxOk.assign(count, 1);
+    for (size_t i = 0; i < count; ++i)
+        if (!pullMacHeader(pool[rxBatch[i]])) rxOk[i] = 0;
+
+    // δƬ֡㴦ĳݱʱȰѻܵĶν
+    // ٽͷۣ֤ذ˳򽻸
+    rxSegments.clear();
+    size_t good = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (!rxOk[i]) continue;
+        Packet& pkt = pool[rxBatch[i]];
+        const IpHeader* ip = pullIpHeader(pkt);
+        if (!ip) continue;
+        if ((NetToHost16(ip->fragment) & (IP_FLAG_MF | IP_OFFSET_MASK)) == 0) {
+            rxSegments.push_back(Segment{ &pkt, ip });
+            continue;
+        }
+        int slot = reassemble(ip, pkt);
+        if (slot < 0) continue;
+        good += deliverSegments(out);
+        rxSegments.push_back(Segment{ &reassembler.packet(slot), ip });
+        good += deliverSegments(out);
+        reassembler.release(slot);
+    }
+    good += deliverSegments(out);
+
+    for (PacketHandle p : rxBatch) pool.release(p);
+    return good;
+}
+
+// ------------------ ץط ------------------
+// ÿ֡ƽͬһԤõĻٽװطŹ̲ڴ
+size_t ProtocolStack::replay(PcapReader& reader) {
+    if (reader.getLinkType() != PCAP_LINKTYPE_ETHERNET) {
+        if (verbose) cout << "̫ץļ޷طš\n\n";
+        return 0;
+    }
+    replayPacket.buffer.resize(Packet::HEADROOM + PCAP_SNAPLEN);
+    size_t good = 0;
+    const unsigned char* frame;
+    uint32_t n;
+    while (reader.next(frame, n)) {
+        replayPacket.assign(frame, n);
+        if (decapsulate(replayPacket)) ++good;
+    }
+    return good;
 }
@@ -1,20 +1,121 @@
 #ifndef PROTOCOLSTACK_H
 #define PROTOCOLSTACK_H
 
-#include <queue>
+#include <cstdint>
+#include <memory>
+#include <span>
 #include <string>
+#include <vector>
+#include "Checksum.h"
+#include "FlowScheduler.h"
 #include "Packet.h"
+#include "PacketPool.h"
+#include "Pcap.h"
+#include "Reassembly.h"
+#include "SpscRing.h"
 
+// Ͷն֮ͨ SPSC ݰ
+// sendData  receiveData Էֱ߳Уݰȫ̲ơ
+//  MTU ݱƬնٽ
 class ProtocolStack {
+public:
+    static const size_t QUEUE_CAPACITY = 1024;  // ͶͬʱҲݰشС
+    static const size_t PACKET_BUFFER = 2048;   // ÿݰԤĻֽ
+
 private:
-    std::queue<Packet> sendQueue;
+    PacketPool pool;
+    SpscRing<PacketHandle> sendQueue;
+    uint32_t nextSeq = 1;       // TCP 
+    uint16_t nextIpId = 1;      // IP ʶ
+    uint16_t ipBaseChecksum;    // ɱֶΣܳȡʶƬַȡ 0 ʱ IP ͷУ
+    size_t mtu = DEFAULT_MTU;   // IP ݱ IP ͷ󳤶
+    bool verbose = true;        // Ƿӡװ/װ
+    Reassembler reassembler;    // ֻɽնʹ
+    std::unique_ptr<FlowScheduler> scheduler;   // ʱİŶ
+    PcapWriter* capture = nullptr;  // ǿʱÿһ֡ͬʱд pcap ļ
+    Packet replayPacket;            // طʱõĽջ
+
+    // һѹ IP/MAC ͷķƬ
+    struct Fragment {
+        PacketHandle handle;
+        uint16_t id;            // ݱ IP ʶ
+        uint16_t fragment;      // ־λ + Ƭƫ
+    };
+
+    std::vector<PacketHandle> txBatch;      // ӿڵĹ
+    std::vector<Fragment> txFragments;
+    std::vector<PacketHandle> rxBatch;
+    // Ѱ IP ͷ㴦ĶΣip ָ IP ͷУ TCP αͷã
+    struct Segment {
+        Packet* pkt;
+        const IpHeader* ip;
+    };
+    std::vector<Segment> rxSegments;
+    std::vector<char> rxSegmentOk;
+    std::vector<char> rxOk;
+
+    // ͷѹ
+    void pushAppHeader(Packet& pkt);
+    void pushTcpHeader(Packet& pkt, const FlowKey& flow);
+    void pushIpHeader(Packet& pkt, const FlowKey& flow, uint16_t id, uint16_t fragment);
+    void pushMacHeader(Packet& pkt);
+    static const MacHeader* pullMacHeader(Packet& pkt);
+    static const IpHeader* pullIpHeader(Packet& pkt);
+    static const TcpHeader* pullTcpHeader(Packet& pkt, const IpHeader* ip);
+    static const AppHeader* pullAppHeader(Packet& pkt);
+
+    // Ƭh  TCP Σ MTU зֺ׷ӵ outһƬ h ض̸ã
+    // ݰزʱ黹ȡݰ false
+    bool fragment(PacketHandle h, std::vector<Fragment>& out);
+    // һݸطװɣɸ֡Ž txFragmentsʧʱԭ
+    bool encapsulateDatagram(const FlowKey& flow, const std::string& data);
+    // Ѱ IP ͷݽֵͬ Reassembler::add
+    int reassemble(const IpHeader* ip, Packet& pkt);
+    bool decapsulateSegment(Packet& seg, const IpHeader* ip);
+    size_t deliverSegments(std::vector<std::string>* out);
+    // ֡뷢ͶУץʱд pcap
+    void queueFrame(PacketHandle h);
 
 public:
+    explicit ProtocolStack(size_t capacity = QUEUE_CAPACITY);
+
+    // رպ sendData / receiveData ̨
+    void setVerbose(bool on) { verbose = on; }
+
+    //  MTUС IPv4 Сֵ 68 ʱȡ 68֮Ϊ֡
+    void setMtu(size_t value);
+    size_t getMtu() const { return mtu; }
+
+    // װΪ֡Ƭ
     void encapsulate(Packet& pkt);
-    void decapsulate(Packet pkt);
+    // װһ֡յδķƬʱ true 
+    bool decapsulate(Packet& pkt);
 
     void sendData(const std::string& data);
     void receiveData();
+
+    // ͣ flow ԪװŽĶУɵ˳
+    bool sendFlow(const FlowKey& flow, const std::string& data);
+    // ˳ n ֡ӸƵͶУƶĸ
+    size_t transmit(size_t n);
+    // ΪգĬ DRR
+    bool setScheduler(std::unique_ptr<FlowScheduler> s);
+    const FlowScheduler& getScheduler() const { return *scheduler; }
+    size_t poolSize() const { return pool.size(); }
+
+    // ץ֮͵֡д wɵ÷򿪺͹رգ nullptr ֹͣ
+    void setCapture(PcapWriter* w) { capture = w; }
+    bool isCapturing() const { return capture != nullptr; }
+    // طţ reader ʣ̫֡ decapsulateؽװɹ֡
+    size_t replay(PcapReader& reader);
+
+    // ͣ㴦ݰȫѹ App ͷȫѹ TCP ͷ
+    // ̨ʵʷĸظĸݰþʱǰֹͣ
+    size_t sendBatch(std::span<const std::string> payloads);
+
+    // գȡ n ֡װصõظ
+    // out ǿʱѸ׷ӽȥ
+    size_t receiveBatch(size_t n, std::vector<std::string>* out = nullptr);
 };
 
 #endif
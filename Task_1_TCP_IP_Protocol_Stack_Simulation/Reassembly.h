@@ -0,0 +1,148 @@
+#ifndef REASSEMBLY_H
+#define REASSEMBLY_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <vector>
+#include "Packet.h"
+using namespace std;
+
+// IP Ƭ
+// ͬʱݱޣÿڹʱԤһ IP ݱСĻ
+// ƬʱֱӸƵеλãÿֻֽһΣ
+// յֽڷΧ  -> յ ¼ʱϲO(log Ƭ)
+// þʱ̭δµǸ൱ڳʱ
+class Reassembler {
+public:
+    static const int PENDING = -1;  // Ƭ£ݱδ
+    static const int DROPPED = -2;  // ƬЧѶ
+
+private:
+    static const size_t MAX_DATAGRAM = 65535 - sizeof(IpHeader);   // ݵ󳤶
+
+    struct Slot {
+        bool used = false;
+        uint32_t srcIP = 0;             // ֻֽڱȽ
+        uint32_t dstIP = 0;
+        uint16_t id = 0;
+        uint8_t protocol = 0;
+        size_t total = 0;               // յһƬ֪ܳȣ֮ǰΪ 0
+        uint64_t stamp = 0;             // һθµţ̭
+        map<uint32_t, uint32_t> ranges; // յֽ [, յ)
+        Packet pkt;                     // 黺ݴ HEADROOM ʼ
+    };
+
+    vector<Slot> slots;
+    uint64_t clock;
+
+    int find(const IpHeader* ip) const {
+        for (size_t i = 0; i < slots.size(); ++i) {
+            const Slot& s = slots[i];
+            if (s.used && s.id == ip->id && s.srcIP == ip->srcIP && s.dstIP == ip->dstIP && s.protocol == ip->protocol)
+                return (int)i;
+        }
+        return -1;
+    }
+
+    // ҿղۣṷ̂δµ
+    int allocate() {
+        int victim = 0;
+        for (size_t i = 0; i < slots.size(); ++i) {
+            if (!slots[i].used) return (int)i;
+            if (slots[i].stamp < slots[victim].stamp) victim = (int)i;
+        }
+        release(victim);
+        return victim;
+    }
+
+    // ¼ [begin, end)صӵϲ
+    static void addRange(map<uint32_t, uint32_t>& ranges, uint32_t begin, uint32_t end) {
+        auto it = ranges.upper_bound(begin);
+        if (it != ranges.begin()) {
+            auto p = prev(it);
+            if (p->second >= begin) {
+                begin = p->first;
+                end = max(end, p->second);
+                it = ranges.erase(p);
+            }
+        }
+        while (it != ranges.end() && it->first <= end) {
+            end = max(end, it->second);
+            it = ranges.erase(it);
+        }
+        ranges.emplace(begin, end);
+    }
+
+public:
+    explicit Reassembler(size_t slotCount = 8) : slots(slotCount), clock(0) {
+        for (Slot& s : slots) s.pkt.buffer.resize(Packet::HEADROOM + MAX_DATAGRAM);
+    }
+
+    Reassembler(const Reassembler&) = delete;
+    Reassembler& operator=(const Reassembler&) = delete;
+
+    // һƬip Ϊ IP ͷdata/len Ϊ IP ͷ֮ݡ
+    // ݱʱزۺţ˺ͨ packet(ۺ) ȡݣ release
+    int add(const IpHeader* ip, const unsigned char* data, size_t len) {
+        uint16_t frag = NetToHost16(ip->fragment);
+        size_t offset = (size_t)(frag & IP_OFFSET_MASK) * 8;
+        bool more = (frag & IP_FLAG_MF) != 0;
+        if (offset + len > MAX_DATAGRAM || (more && len % 8 != 0)) return DROPPED;
+
+        int i = find(ip);
+        if (i < 0) {
+            i = allocate();
+            Slot& s = slots[i];
+            s.used = true;
+            s.srcIP = ip->srcIP;
+            s.dstIP = ip->dstIP;
+            s.id = ip->id;
+            s.protocol = ip->protocol;
+        }
+        Slot& s = slots[i];
+        s.stamp = ++clock;
+        // ֪߽ìʱݱţͬղһ
+        bool conflict;
+        if (more) conflict = s.total && offset + len > s.total;     // Խ֪ܳ
+        else if (s.total) conflict = s.total != offset + len;       // "һƬ"ì
+        else conflict = !s.ranges.empty() && s.ranges.rbegin()->second > offset + len;  // ԽһƬյ
+        if (conflict) {
+            release(i);
+            return DROPPED;
+        }
+        if (!more) s.total = offset + len;
+
+        memcpy(s.pkt.buffer.data() + Packet::HEADROOM + offset, data, len);
+        addRange(s.ranges, (uint32_t)offset, (uint32_t)(offset + len));
+
+        if (s.total && s.ranges.size() == 1 && s.ranges.begin()->first == 0 && s.ranges.begin()->second == s.total) {
+            s.pkt.head = Packet::HEADROOM;
+            s.pkt.len = s.total;
+            return i;
+        }
+        return PENDING;
+    }
+
+    Packet& packet(int slot) {
+        return slots[slot].pkt;
+    }
+
+    // ͷۣһݱ
+    void release(int slot) {
+        Slot& s = slots[slot];
+        s.used = false;
+        s.total = 0;
+        s.ranges.clear();
+    }
+
+    // еݱ
+    size_t pending() const {
+        size_t n = 0;
+        for (const Slot& s : slots) n += s.used ? 1 : 0;
+        return n;
+    }
+};
+
+#endif
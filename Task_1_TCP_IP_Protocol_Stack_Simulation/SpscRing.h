@@ -0,0 +1,75 @@
+#ifndef SPSCRING_H
+#define SPSCRING_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+using namespace std;
+
+// н絥/ζ
+// ֻһ߳ pushһ߳ popд±ռһУ
+// ˸ԻԷ±ֻ꣬ڿ/ʱȥԷԭӱ
+template <class T>
+class SpscRing {
+private:
+    static const size_t CACHE_LINE = 64;
+
+    vector<T> slots;
+    size_t mask;
+
+    alignas(CACHE_LINE) atomic<size_t> head;    // һҪλãд
+    size_t cachedTail;                          // ߿ tail
+    alignas(CACHE_LINE) atomic<size_t> tail;    // һҪдλãд
+    size_t cachedHead;                          // ߿ head
+
+public:
+    // ȡΪ 2 
+    explicit SpscRing(size_t capacity) : head(0), cachedTail(0), tail(0), cachedHead(0) {
+        size_t n = 1;
+        while (n < capacity) n <<= 1;
+        slots.resize(n);
+        mask = n - 1;
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // ߵãʱ false
+    bool push(const T& v) {
+        size_t t = tail.load(memory_order_relaxed);
+        if (t - cachedHead == slots.size()) {
+            cachedHead = head.load(memory_order_acquire);
+            if (t - cachedHead == slots.size()) return false;
+        }
+        slots[t & mask] = v;
+        tail.store(t + 1, memory_order_release);
+        return true;
+    }
+
+    // ߵãпʱ false
+    bool pop(T& v) {
+        size_t h = head.load(memory_order_relaxed);
+        if (h == cachedTail) {
+            cachedTail = tail.load(memory_order_acquire);
+            if (h == cachedTail) return false;
+        }
+        v = slots[h & mask];
+        head.store(h + 1, memory_order_release);
+        return true;
+    }
+
+    // ǰԪظʱֻǽֵ
+    size_t size() const {
+        return tail.load(memory_order_acquire) - head.load(memory_order_acquire);
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    size_t capacity() const {
+        return slots.size();
+    }
+};
+
+#endif
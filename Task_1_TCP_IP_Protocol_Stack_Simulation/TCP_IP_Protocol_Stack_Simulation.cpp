@@ -1,5 +1,15 @@
 #include <iostream>
+#include <iomanip>
 #include <cstdlib>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <span>
+#include <vector>
+#include "Checksum.h"
+#include "FlowScheduler.h"
+#include "Pcap.h"
 #include "ProtocolStack.h"
 
 using namespace std;
@@ -9,8 +19,169 @@ void CleanDOS() {
     system("cls"); // տ̨Ļ
 }
 
+// շ²ԣͬ 64 ֽݰֱӿС 1/32/256 շ
+void RunBatchBenchmark() {
+    const size_t TOTAL = 1000000;
+    const size_t batchSizes[] = { 1, 32, 256 };
+    vector<string> payloads(256, string(64, 'x'));
+
+    cout << "\nʽ       | ݰ | ʱ(ms) | (/) | У\n";
+    auto report = [&](const string& name, double ms, size_t received) {
+        cout << left << setw(10) << name << right << " | " << setw(8) << TOTAL << " | "
+            << setw(8) << fixed << setprecision(1) << ms << " | "
+            << setw(11) << setprecision(0) << TOTAL / (ms / 1000) << " | "
+            << (received == TOTAL ? "ͨ" : "ʧ") << "\n";
+        cout.unsetf(ios::fixed);
+        cout << setprecision(6);
+    };
+
+    {
+        ProtocolStack stack;
+        stack.setVerbose(false);
+        auto t0 = chrono::steady_clock::now();
+        for (size_t i = 0; i < TOTAL; ++i) {
+            stack.sendData(payloads[0]);
+            stack.receiveData();
+        }
+        auto t1 = chrono::steady_clock::now();
+        report("", chrono::duration<double, milli>(t1 - t0).count(), TOTAL);
+    }
+
+    for (size_t b : batchSizes) {
+        ProtocolStack stack;
+        size_t received = 0;
+        auto t0 = chrono::steady_clock::now();
+        for (size_t sent = 0; sent < TOTAL; sent += b) {
+            size_t n = min(b, TOTAL - sent);
+            stack.sendBatch(span<const string>(payloads.data(), n));
+            received += stack.receiveBatch(n);
+        }
+        auto t1 = chrono::steady_clock::now();
+        report("С " + to_string(b), chrono::duration<double, milli>(t1 - t0).count(), received);
+    }
+}
+
+volatile uint32_t benchmarkSink;
+
+// Уں²ԣں 64 B ~ 64 KB Ϸ㣬 GB/s
+void RunChecksumBenchmark() {
+    const size_t sizes[] = { 64, 256, 1024, 4096, 16384, 65536 };
+    const size_t BYTES_PER_RUN = 256 << 20;     // ÿۼƴ 256 MB
+    typedef uint16_t (*Kernel)(const void*, size_t);
+    struct Entry {
+        const char* name;
+        Kernel kernel;
+        bool available;
+    };
+    const Entry kernels[] = {
+        { "", ChecksumScalar, true },
+        { "SSE2", ChecksumSse2, ChecksumHasSse2() },
+        { "AVX2", ChecksumAvx2, ChecksumHasAvx2() },
+    };
+
+    vector<unsigned char> data(65536 + 1);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = (unsigned char)(i * 131 + 7);
+
+    cout << "\nǰѡںˣ" << ChecksumKernelName() << "\n";
+    cout << "ݴС |";
+    for (const Entry& k : kernels) cout << setw(10) << k.name << " |";
+    cout << "  (GB/s)\n";
+    for (size_t size : sizes) {
+        cout << setw(8) << size << " |";
+        for (const Entry& k : kernels) {
+            if (!k.available) {
+                cout << setw(10) << "-" << " |";
+                continue;
+            }
+            size_t rounds = BYTES_PER_RUN / size;
+            uint32_t sink = 0;
+            auto t0 = chrono::steady_clock::now();
+            for (size_t r = 0; r < rounds; ++r) sink += k.kernel(data.data() + (r & 1), size);  // Ƕ
+            auto t1 = chrono::steady_clock::now();
+            double sec = chrono::duration<double>(t1 - t0).count();
+            cout << setw(10) << fixed << setprecision(2) << (double)rounds * size / sec / 1e9 << " |";
+            cout.unsetf(ios::fixed);
+            benchmarkSink = sink;   // ֹѭŻ
+        }
+        cout << "\n";
+    }
+    cout << setprecision(6);
+}
+
+// ²ԣ10000  65536 ݰڶУ
+// ̬ÿһͰͬһĳͳÿĳ+Ӵ
+// ֡ 64 ǰ MTU Ӧ֮֡DRR ȡ֡
+void RunSchedulerBenchmark(size_t mtu) {
+    const size_t FLOWS = 10000;
+    const size_t PACKETS = 1 << 16;
+    const size_t OPS = 10000000;
+
+    vector<FlowKey> keys(FLOWS);
+    for (size_t i = 0; i < FLOWS; ++i)
+        keys[i] = { 0x0A000000u + (uint32_t)i, DEFAULT_DST_IP, (uint16_t)(1024 + i), DEFAULT_DST_PORT, IP_PROTO_TCP };
+    // Ԥ֡ʱֲ
+    const uint32_t maxFrame = (uint32_t)(mtu + sizeof(MacHeader));
+    mt19937 rng(12345);
+    vector<uint32_t> flowOf(1 << 20), sizeOf(1 << 20);
+    for (size_t i = 0; i < flowOf.size(); ++i) {
+        flowOf[i] = rng() % FLOWS;
+        sizeOf[i] = 64 + rng() % (maxFrame - 64 + 1);
+    }
+    const size_t MASK = flowOf.size() - 1;
+
+    unique_ptr<FlowScheduler> schedulers[] = {
+        make_unique<RoundRobinScheduler>(PACKETS),
+        make_unique<DrrScheduler>(PACKETS, maxFrame),
+    };
+
+    cout << "\nMTU " << mtu << "֡ " << maxFrame << " ֽ\n";
+    cout << " |   |    | ʱ(ms) | (/) | Ծ\n";
+    for (auto& s : schedulers) {
+        size_t r = 0;
+        for (PacketHandle h = 0; h < PACKETS; ++h, ++r) s->enqueue(keys[flowOf[r & MASK]], h, sizeOf[r & MASK]);
+        size_t active = s->activeFlows();
+
+        auto t0 = chrono::steady_clock::now();
+        PacketHandle h;
+        for (size_t i = 0; i < OPS / 2; ++i, ++r) {
+            s->dequeue(h);
+            s->enqueue(keys[flowOf[r & MASK]], h, sizeOf[r & MASK]);
+        }
+        auto t1 = chrono::steady_clock::now();
+        while (s->dequeue(h)) {}
+
+        double ms = chrono::duration<double, milli>(t1 - t0).count();
+        cout << left << setw(6) << s->name() << right << " | " << setw(5) << FLOWS << " | " << setw(8) << OPS << " | "
+            << setw(8) << fixed << setprecision(1) << ms << " | "
+            << setw(15) << setprecision(2) << OPS / ms / 1000 << " | " << active << "\n";
+        cout.unsetf(ios::fixed);
+    }
+    cout << setprecision(6);
+}
+
+// ط pcap ļرȫٽװͳ֡
+void RunReplay(ProtocolStack& stack, const string& path) {
+    PcapReader reader;
+    if (!reader.open(path)) {
+        cout << "޷򿪻 pcap ļ" << path << "\n";
+        return;
+    }
+    stack.setVerbose(false);
+    auto t0 = chrono::steady_clock::now();
+    size_t good = stack.replay(reader);
+    auto t1 = chrono::steady_clock::now();
+    stack.setVerbose(true);
+
+    double ms = chrono::duration<double, milli>(t1 - t0).count();
+    cout << "طɣļ " << reader.size() << " ֽڣװɹ " << good << " ֡ʱ "
+        << fixed << setprecision(1) << ms << " ms" << setprecision(0) << reader.size() / ms / 1000 << " MB/s\n";
+    cout.unsetf(ios::fixed);
+    cout << setprecision(6);
+}
+
 int main() {
     ProtocolStack stack;
+    PcapWriter capture;
 
     cout << "=== ģ TCP/IP Эջװװ ===\n\n";
 
@@ -32,6 +203,12 @@ int main() {
         cout << "----- ˵ -----\n";
         cout << "1. \n";
         cout << "2. \n";
+        cout << "3. շ²\n";
+        cout << "4.  MTUǰ " << stack.getMtu() << "\n";
+        cout << "5. Уں²\n";
+        cout << "6. ²\n";
+        cout << (stack.isCapturing() ? "7. ֹͣץ\n" : "7. ʼץд pcap ļ\n");
+        cout << "8. ط pcap ļ\n";
         cout << "0. ˳\n";
         cout << "\nѡ: ";
 
@@ -47,7 +224,51 @@ int main() {
         } else if (choice == "2") {
             stack.receiveData();
 			CleanDOS();
+        } else if (choice == "3") {
+            RunBatchBenchmark();
+            CleanDOS();
+        } else if (choice == "4") {
+            cout << " MTUֽڣС " << MIN_MTU << ": ";
+            string line;
+            if (!getline(cin, line)) break;
+            try {
+                stack.setMtu((size_t)stoul(line));
+                cout << "MTU Ϊ " << stack.getMtu() << "\n";
+            } catch (const exception&) {
+                cout << "Ч\n";
+            }
+            CleanDOS();
+        } else if (choice == "5") {
+            RunChecksumBenchmark();
+            CleanDOS();
+        } else if (choice == "6") {
+            RunSchedulerBenchmark(stack.getMtu());
+            CleanDOS();
+        } else if (choice == "7") {
+            if (stack.isCapturing()) {
+                stack.setCapture(nullptr);
+                capture.close();
+                cout << "ֹͣץд " << capture.frameCount() << " ֡\n";
+            } else {
+                cout << " pcap ļ: ";
+                string path;
+                if (!getline(cin, path)) break;
+                if (capture.open(path)) {
+                    stack.setCapture(&capture);
+                    cout << "ʼץ֮͵֡д " << path << "\n";
+                } else {
+                    cout << "޷ļ" << path << "\n";
+                }
+            }
+            CleanDOS();
+        } else if (choice == "8") {
+            cout << " pcap ļ: ";
+            string path;
+            if (!getline(cin, path)) break;
+            RunReplay(stack, path);
+            CleanDOS();
         } else if (choice == "0") {
+            stack.setCapture(nullptr);
             cout << "˳\n";
             break;
         } else {
@@ -0,0 +1,122 @@
+#pragma once
+#include <cstddef>
+
+// AVL ƽڵ
+// һڵ߶Ȳ 1߲ 1.44 log2(n+2)롢ɾҾΪ O(log n)ȫʵ֡
+// ͨһظֵתȵֵܳһ࣬
+// Ϊ  <=  <= 
+struct AVLNode {
+    int val;
+    int height;     // ԸýڵΪ߶ȣҶΪ 1
+    AVLNode* left;
+    AVLNode* right;
+
+    AVLNode(int x) : val(x), height(1), left(NULL), right(NULL) {}
+};
+
+inline int nodeHeight(AVLNode* node) {
+    return node ? node->height : 0;
+}
+
+inline void updateHeight(AVLNode* node) {
+    int l = nodeHeight(node->left), r = nodeHeight(node->right);
+    node->height = (l > r ? l : r) + 1;
+}
+
+// ӳΪµĸ
+inline AVLNode* rotateRight(AVLNode* node) {
+    AVLNode* l = node->left;
+    node->left = l->right;
+    l->right = node;
+    updateHeight(node);
+    updateHeight(l);
+    return l;
+}
+
+// ҺӳΪµĸ
+inline AVLNode* rotateLeft(AVLNode* node) {
+    AVLNode* r = node->right;
+    node->right = r->left;
+    r->left = node;
+    updateHeight(node);
+    updateHeight(r);
+    return r;
+}
+
+// ߶ȱ仯ָƽ⣬µ
+inline AVLNode* rebalance(AVLNode* node) {
+    updateHeight(node);
+    int balance = nodeHeight(node->left) - nodeHeight(node->right);
+    if (balance > 1) {
+        if (nodeHeight(node->left->left) < nodeHeight(node->left->right))  // LR Ȱ
+            node->left = rotateLeft(node->left);
+        return rotateRight(node);
+    }
+    if (balance < -1) {
+        if (nodeHeight(node->right->right) < nodeHeight(node->right->left))    // RL ȰҺ
+            node->right = rotateRight(node->right);
+        return rotateLeft(node);
+    }
+    return node;
+}
+
+// Ӹ޸Ĵ·path[i] ·ϵ i ڵ丸ڵеǸָ롣
+// ߲ 1.44 log2(n+2)64 㹻κܷŽڴ
+const int AVL_MAX_HEIGHT = 64;
+
+// ·¶ϻָƽ
+inline void rebalancePath(AVLNode** path[], int depth) {
+    while (depth-- > 0) *path[depth] = rebalance(*path[depth]);
+}
+
+// ڵ㵽 AVL 
+inline AVLNode* insert(AVLNode* root, int val) {
+    AVLNode** path[AVL_MAX_HEIGHT];
+    int depth = 0;
+    AVLNode** link = &root;
+    while (*link != NULL) {
+        path[depth++] = link;
+        if (val < (*link)->val) {
+            link = &(*link)->left;
+        }
+        else { // ظֵұ
+            link = &(*link)->right;
+        }
+    }
+    *link = new AVLNode(val);
+    rebalancePath(path, depth);
+    return root;
+}
+
+// ɾһֵΪ key Ľڵ㣨
+inline AVLNode* deleteNode(AVLNode* root, int key) {
+    AVLNode** path[AVL_MAX_HEIGHT];
+    int depth = 0;
+    AVLNode** link = &root;
+    while (*link != NULL && (*link)->val != key) {
+        path[depth++] = link;
+        link = key < (*link)->val ? &(*link)->left : &(*link)->right;
+    }
+    AVLNode* node = *link;
+    if (node == NULL) return root;
+
+    if (node->left == NULL || node->right == NULL) {
+        *link = node->left ? node->left : node->right;
+        delete node;
+    }
+    else {
+        // ӽڵ㣺еСڵ㣨ֵ̣滻ժú
+        path[depth++] = link;
+        AVLNode** succLink = &node->right;
+        while ((*succLink)->left != NULL) {
+            path[depth++] = succLink;
+            succLink = &(*succLink)->left;
+        }
+        AVLNode* succ = *succLink;
+        node->val = succ->val;
+        *succLink = succ->right;
+        delete succ;
+    }
+    rebalancePath(path, depth);
+    return root;
+}
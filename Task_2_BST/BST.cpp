@@ -1,7 +1,20 @@
 #include <iostream>
+#include <iomanip>
 #include <vector>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <random>
 #include <cstdlib> // rand() and srand()
 #include <ctime>   // time()
+#include <climits>
+#include <map>
+#include <thread>
+#include "AVLTree.h"
+#include "ConcurrentBST.h"
+#include "MultisetBST.h"
+#include "FrozenBST.h"
+#include "TreeTraversal.h"
 
 using namespace std;
 
@@ -14,102 +27,83 @@ struct TreeNode {
     TreeNode(int x) : val(x), left(NULL), right(NULL) {}
 };
 
-// ڵ㵽
+// ڵ㵽;Ҫ޸ĵָ룬˻Ҳջ
 TreeNode* insert(TreeNode* root, int val) {
-    if (root == NULL) {
-        return new TreeNode(val);
-    }
-    if (val < root->val) {
-        root->left = insert(root->left, val);
-    }
-    else if (val >= root->val) { // ظֵظֵұ
-        root->right = insert(root->right, val);
+    TreeNode** link = &root;
+    while (*link != NULL) {
+        if (val < (*link)->val) {
+            link = &(*link)->left;
+        }
+        else { // ظֵظֵұ
+            link = &(*link)->right;
+        }
     }
+    *link = new TreeNode(val);
     return root;
 }
 
-// Сֵڵ㣨ɾѰСڵ㣩
-TreeNode* minValueNode(TreeNode* node) {
-    TreeNode* current = node;
-    while (current && current->left != NULL)
-        current = current->left;
-    return current;
-}
-
-// ɾڵ
+// ɾڵ㣨
 TreeNode* deleteNode(TreeNode* root, int key) {
-    if (root == NULL) return root;
-
-    // 1. ѰҪɾĽڵ
-    if (key < root->val) {
-        root->left = deleteNode(root->left, key);
-    }
-    else if (key > root->val) {
-        root->right = deleteNode(root->right, key);
+    // 1. ѰҪɾĽڵ㣬link ָ򸸽ڵָǸָ
+    TreeNode** link = &root;
+    while (*link != NULL && (*link)->val != key) {
+        link = key < (*link)->val ? &(*link)->left : &(*link)->right;
     }
-    else {
-        // 2. ҵڵ㣬ɾ
+    TreeNode* node = *link;
+    if (node == NULL) return root;
 
-        // A: ֻһӽڵ  ûӽڵ
-        if (root->left == NULL) {
-            TreeNode* temp = root->right;
-            delete root;
-            return temp;
-        }
-        else if (root->right == NULL) {
-            TreeNode* temp = root->left;
-            delete root;
-            return temp;
-        }
+    // 2. ҵڵ㣬ɾ
 
-        // B: ӽڵ
-        // ȡеСڵ㣨̣
-        TreeNode* temp = minValueNode(root->right);
-
-        // ̽ڵֵƵǰڵ
-        root->val = temp->val;
-
-        // ɾеǸ̽ڵ
-        root->right = deleteNode(root->right, temp->val);
+    // A: ֻһӽڵ  ûӽڵ
+    if (node->left == NULL || node->right == NULL) {
+        *link = node->left ? node->left : node->right;
+        delete node;
+        return root;
     }
+
+    // B: ӽڵ
+    // ȡеСڵ㣨ֵ̣Ƶǰڵ㣬ժ̣ûӣ
+    TreeNode** succLink = &node->right;
+    while ((*succLink)->left != NULL) succLink = &(*succLink)->left;
+    TreeNode* succ = *succLink;
+    node->val = succ->val;
+    *succLink = succ->right;
+    delete succ;
     return root;
 }
 
 // ǰ ( ->  -> )
-void preOrder(TreeNode* root) {
-    if (root != NULL) {
-        cout << root->val << " ";
-        preOrder(root->left);
-        preOrder(root->right);
-    }
+template <class Node>
+void preOrder(Node* root) {
+    ValueWriter out(cout);
+    preOrderVisit(root, out);
 }
 
 //  ( ->  -> )
-void inOrder(TreeNode* root) {
-    if (root != NULL) {
-        inOrder(root->left);
-        cout << root->val << " ";
-        inOrder(root->right);
-    }
+template <class Node>
+void inOrder(Node* root) {
+    ValueWriter out(cout);
+    inOrderVisit(root, out);
 }
 
 //  ( ->  -> )
-void postOrder(TreeNode* root) {
-    if (root != NULL) {
-        postOrder(root->left);
-        postOrder(root->right);
-        cout << root->val << " ";
-    }
+template <class Node>
+void postOrder(Node* root) {
+    ValueWriter out(cout);
+    postOrderVisit(root, out);
 }
 
 // ûѡִб
-void selectChoice(TreeNode* root) {
+template <class Node>
+void selectChoice(Node* root) {
     int choice;
     cout << "\nѡʽ:\n";
     cout << "1. ǰ (Pre-order)\n";
     cout << "2.  (In-order)\n";
     cout << "3.  (Post-order)\n";
-    cout << "ѡ (1-3): ";
+    cout << "4. Morris  (O(1) ռ)\n";
+    cout << "5. Morris ǰ (O(1) ռ)\n";
+    cout << "ѡ (1-5): ";
     cin >> choice;
 
     cout << ": ";
@@ -123,6 +117,16 @@ void selectChoice(TreeNode* root) {
     case 3:
         postOrder(root);
         break;
+    case 4: {
+        ValueWriter out(cout);
+        morrisInOrder(root, out);
+        break;
+    }
+    case 5: {
+        ValueWriter out(cout);
+        morrisPreOrder(root, out);
+        break;
+    }
     default:
         cout << "ЧѡĬִ: ";
         inOrder(root);
@@ -130,26 +134,499 @@ void selectChoice(TreeNode* root) {
     cout << endl;
 }
 
+// ؼģʽıѡMorris Ҫʱдָ룬ﲻṩ
+void selectChoice(const MultisetBST& tree) {
+    int choice;
+    cout << "\nѡʽ:\n";
+    cout << "1. ǰ (Pre-order)\n";
+    cout << "2.  (In-order)\n";
+    cout << "3.  (Post-order)\n";
+    cout << "ѡ (1-3): ";
+    cin >> choice;
+
+    cout << ": ";
+    {
+        ValueWriter out(cout);
+        switch (choice) {
+        case 1:
+            tree.preOrderVisit(out);
+            break;
+        case 3:
+            tree.postOrderVisit(out);
+            break;
+        default:
+            if (choice != 2) cout << "ЧѡĬִ: ";
+            tree.inOrderVisit(out);
+        }
+    }
+    cout << endl;
+}
+
 // ҽڵǷڣ֤룩
-bool search(TreeNode* root, int key) {
-    if (root == NULL) return false;
-    if (root->val == key) return true;
-    if (key < root->val) return search(root->left, key);
-    return search(root->right, key);
+template <class Node>
+bool search(Node* root, int key) {
+    while (root != NULL) {
+        if (root->val == key) return true;
+        root = key < root->val ? root->left : root->right;
+    }
+    return false;
 }
 
-int main() {
-    srand((unsigned)time(0)); // 
+// ź sorted[lo, hi) ȫƽĶO(n)ݹΪ log2(n)
+// ȵֵܷڸ࣬ҡɾӰ
+TreeNode* buildBalanced(const vector<int>& sorted, size_t lo, size_t hi) {
+    if (lo >= hi) return NULL;
+    size_t mid = lo + (hi - lo) / 2;
+    TreeNode* node = new TreeNode(sorted[mid]);
+    node->left = buildBalanced(sorted, lo, mid);
+    node->right = buildBalanced(sorted, mid + 1, hi);
+    return node;
+}
+
+// һκ
+TreeNode* buildBalanced(vector<int> data) {
+    sort(data.begin(), data.end());
+    return buildBalanced(data, 0, data.size());
+}
 
+// ߣΪ 0
+template <class Node>
+int treeHeight(Node* root) {
+    vector<Node*> level, next;
+    if (root) level.push_back(root);
+    int height = 0;
+    while (!level.empty()) {
+        ++height;
+        next.clear();
+        for (Node* node : level) {
+            if (node->left) next.push_back(node->left);
+            if (node->right) next.push_back(node->right);
+        }
+        level.swap(next);
+    }
+    return height;
+}
+
+// ͷӾתɾǰڵҺӣռ O(1)
+template <class Node>
+void destroyTree(Node* root) {
+    while (root != NULL) {
+        if (root->left != NULL) {
+            Node* l = root->left;
+            root->left = l->right;
+            l->right = root;
+            root = l;
+        }
+        else {
+            Node* r = root->right;
+            delete root;
+            root = r;
+        }
+    }
+}
+
+// ͨ򡢴ظ˻Ϊÿβ O(n) O(n^2)
+// ֻܲôСʱ
+const int PLAIN_DEGENERATE_LIMIT = 10000;
+
+typedef chrono::steady_clock Clock;
+
+volatile long long benchmarkSink;
+
+// ܲԵһ
+void printBenchmarkRow(const char* inputName, const char* treeName, size_t keys, int height, size_t nodes, size_t bytes,
+    const Clock::time_point t[4], size_t queries, bool ok) {
+    auto ms = [&](int i) { return chrono::duration<double, milli>(t[i + 1] - t[i]).count(); };
+    cout << left << setw(8) << inputName << setw(8) << treeName << right
+        << setw(9) << keys << setw(7) << height << setw(9) << nodes
+        << fixed << setprecision(1) << setw(10) << bytes / 1048576.0
+        << setw(11) << ms(0) << setw(11) << ms(1) << setw(11) << ms(2)
+        << setprecision(2) << setw(13) << queries / ms(1) / 1000
+        << (ok ? "" : "  ҽ") << "\n";
+    cout.unsetf(ios::fixed);
+}
+
+// һһ룺βȫȫɾǰһ
+template <class Node>
+void benchmarkTree(const char* inputName, const char* treeName, const vector<int>& data, const vector<int>& queries) {
+    Clock::time_point t[4];
+    Node* root = NULL;
+    t[0] = Clock::now();
+    for (int v : data) root = insert(root, v);
+    t[1] = Clock::now();
+    size_t found = 0;
+    for (int v : queries) found += search(root, v) ? 1 : 0;
+    t[2] = Clock::now();
+    int height = treeHeight(root);
+    for (size_t i = 0; i < data.size() / 2; ++i) root = deleteNode(root, data[i]);
+    t[3] = Clock::now();
+    destroyTree(root);
+
+    // ÿֵһڵ㣨ڴ治Ŀ
+    printBenchmarkRow(inputName, treeName, data.size(), height, data.size(), data.size() * sizeof(Node),
+        t, queries.size(), found == queries.size());
+}
+
+void benchmarkMultiset(const char* inputName, const vector<int>& data, const vector<int>& queries) {
+    Clock::time_point t[4];
+    MultisetBST tree;
+    t[0] = Clock::now();
+    for (int v : data) tree.insert(v);
+    t[1] = Clock::now();
+    size_t found = 0;
+    for (int v : queries) found += tree.search(v) ? 1 : 0;
+    t[2] = Clock::now();
+    int height = tree.height();
+    size_t nodes = tree.distinct(), bytes = tree.memoryBytes();
+    for (size_t i = 0; i < data.size() / 2; ++i) tree.deleteNode(data[i]);
+    t[3] = Clock::now();
+
+    printBenchmarkRow(inputName, "ؼ", data.size(), height, nodes, bytes, t, queries.size(), found == queries.size());
+}
+
+// ˳ͳƲѯÿֲѯ 10^6 ΣһȥٷλֻȽ
+void benchmarkOrderStatistics(const vector<int>& data, mt19937& rng) {
+    MultisetBST tree;
+    for (int v : data) tree.insert(v);
+    const size_t Q = 1000000;
+    vector<int> keys(Q);
+    vector<size_t> ranks(Q);
+    for (size_t i = 0; i < Q; ++i) {
+        keys[i] = data[rng() % data.size()];
+        ranks[i] = rng() % tree.size();
+    }
+
+    Clock::time_point t[5];
+    long long sink = 0;
+    t[0] = Clock::now();
+    for (int k : keys) sink += (long long)tree.rank(k);
+    t[1] = Clock::now();
+    for (size_t k : ranks) sink += tree.select(k);
+    t[2] = Clock::now();
+    for (size_t i = 0; i + 1 < Q; ++i) sink += (long long)tree.countInRange(min(keys[i], keys[i + 1]), max(keys[i], keys[i + 1]));
+    t[3] = Clock::now();
+    tree.inOrderCounted([&](int key, uint32_t count) { sink += (long long)key * count; });
+    t[4] = Clock::now();
+
+    auto ns = [&](int i, size_t ops) { return chrono::duration<double, nano>(t[i + 1] - t[i]).count() / ops; };
+    cout << "\n˳ͳƲѯؼ " << tree.size() << " ֵÿ " << Q << " Σ\n";
+    cout << fixed << setprecision(1);
+    cout << "rank          " << setw(10) << ns(0, Q) << " ns/\n";
+    cout << "select        " << setw(10) << ns(1, Q) << " ns/\n";
+    cout << "countInRange  " << setw(10) << ns(2, Q - 1) << " ns/\n";
+    cout << "  " << setw(10) << ns(3, 1) / 1e6 << " ms/\n";
+    cout.unsetf(ios::fixed);
+    benchmarkSink = sink;   // ֹѯŻ
+}
+
+// ܲԣ10^6  /  / ظ1-100
+void runBenchmark() {
+    const int N = 1000000;
+    mt19937 rng(12345);
+
+    struct Input {
+        const char* name;
+        vector<int> data;
+        bool degenerate;    // ͨ˻
+    };
+    Input inputs[3] = { { "", {}, false }, { "", {}, true }, { "ظ", {}, true } };
+    for (int i = 0; i < N; ++i) {
+        inputs[0].data.push_back((int)(rng() >> 1));
+        inputs[1].data.push_back(i);
+        inputs[2].data.push_back((int)(rng() % 100) + 1);
+    }
+
+    cout << "\nͨظֻȡǰ " << PLAIN_DEGENERATE_LIMIT << " \n";
+    cout << left << setw(8) << "" << setw(8) << "" << right << setw(9) << "" << setw(7) << ""
+        << setw(9) << "ڵ" << setw(10) << "ڴ(MB)" << setw(11) << "(ms)" << setw(11) << "(ms)" << setw(11) << "ɾ(ms)" << setw(13) << "(M/s)" << "\n";
+    for (Input& in : inputs) {
+        vector<int> queries = in.data;
+        shuffle(queries.begin(), queries.end(), rng);
+        benchmarkTree<AVLNode>(in.name, "AVL", in.data, queries);
+        benchmarkMultiset(in.name, in.data, queries);
+
+        if (in.degenerate) {
+            vector<int> part(in.data.begin(), in.data.begin() + PLAIN_DEGENERATE_LIMIT);
+            vector<int> partQueries = part;
+            shuffle(partQueries.begin(), partQueries.end(), rng);
+            benchmarkTree<TreeNode>(in.name, "ͨ", part, partQueries);
+        }
+        else {
+            benchmarkTree<TreeNode>(in.name, "ͨ", in.data, queries);
+        }
+    }
+
+    benchmarkOrderStatistics(inputs[0].data, rng);
+}
+
+// ܲԣͬһֱ𽨳 ָ / arena ؼ /  Eytzinger 飨Ϊ
+// Ƚҵ
+void runFrozenBenchmark() {
+    const size_t sizes[] = { 100000, 1000000, 10000000 };
+    const size_t Q = 2000000;
+    mt19937 rng(2024);
+
+    cout << "\n        ṹ        (ms)   ڴ(MB)   (M/s)\n";
+    for (size_t n : sizes) {
+        vector<int> data(n);
+        for (int& v : data) v = (int)(rng() >> 1);
+        vector<int> queries(Q);
+        for (int& q : queries) q = data[rng() % n];
+
+        auto report = [&](const char* name, double buildMs, size_t bytes, Clock::time_point a, Clock::time_point b, size_t found) {
+            double ms = chrono::duration<double, milli>(b - a).count();
+            cout << left << setw(12) << n << setw(12) << name << right << fixed << setprecision(1)
+                << setw(8) << buildMs << setw(11) << bytes / 1048576.0
+                << setprecision(2) << setw(12) << Q / ms / 1000
+                << (found == Q ? "" : "  ҽ") << "\n";
+            cout.unsetf(ios::fixed);
+        };
+
+        {
+            auto t0 = Clock::now();
+            TreeNode* root = buildBalanced(data);
+            auto t1 = Clock::now();
+            size_t found = 0;
+            for (int q : queries) found += search(root, q) ? 1 : 0;
+            auto t2 = Clock::now();
+            report("ָ", chrono::duration<double, milli>(t1 - t0).count(), n * sizeof(TreeNode), t1, t2, found);
+            destroyTree(root);
+        }
+        {
+            MultisetBST tree;
+            auto t0 = Clock::now();
+            tree.build(data);
+            auto t1 = Clock::now();
+            size_t found = 0;
+            for (int q : queries) found += tree.search(q) ? 1 : 0;
+            auto t2 = Clock::now();
+            report("ؼ", chrono::duration<double, milli>(t1 - t0).count(), tree.memoryBytes(), t1, t2, found);
+        }
+        {
+            FrozenBST frozen;
+            auto t0 = Clock::now();
+            frozen.build(data);
+            auto t1 = Clock::now();
+            size_t found = 0;
+            for (int q : queries) found += frozen.search(q) ? 1 : 0;
+            auto t2 = Clock::now();
+            report("", chrono::duration<double, milli>(t1 - t0).count(), frozen.memoryBytes(), t1, t2, found);
+        }
+    }
+}
+
+// һ汾ԣϸΪ߶Сֶȷ AVL ƽ⡣
+// ""İ汾ͷŵĽڵ㣬ＸȻ
+bool validateVersion(const ConcurrentBST::Node* root) {
+    typedef const ConcurrentBST::Node* NodePtr;
+    vector<NodePtr> order;
+    vector<NodePtr> stack;
+    for (NodePtr n = root; n || !stack.empty(); n = n->right) {
+        for (; n; n = n->left) stack.push_back(n);
+        n = stack.back();
+        stack.pop_back();
+        order.push_back(n);
+    }
+    for (size_t i = 0; i < order.size(); ++i) {
+        NodePtr n = order[i];
+        if (n->count == 0) return false;
+        if (i > 0 && order[i - 1]->key >= n->key) return false;
+        int hl = n->left ? n->left->height : 0, hr = n->right ? n->right->height : 0;
+        size_t sl = n->left ? n->left->size : 0, sr = n->right ? n->right->size : 0;
+        if (n->height != max(hl, hr) + 1 || hl - hr > 1 || hr - hl > 1) return false;
+        if (n->size != sl + sr + n->count) return false;
+    }
+    return true;
+}
+
+// ѹԣһд/ɾ߲ͣȡɨԼ飬
+// дά std::map ȶ
+void runConcurrentStressTest() {
+    const int KEYS = 100000;
+    const int READERS = 4;
+    const chrono::milliseconds DURATION(3000);
+
+    ConcurrentBST tree;
+    map<int, uint32_t> reference;
+    {
+        mt19937 rng(7);
+        vector<int> data(200000);
+        for (int& v : data) {
+            v = (int)(rng() % KEYS);
+            ++reference[v];
+        }
+        tree.build(data);
+    }
+
+    atomic<bool> stop(false);
+    atomic<long long> snapshots(0), scanned(0), failures(0);
+    long long writes = 0;
+
+    vector<thread> readers;
+    for (int r = 0; r < READERS; ++r) {
+        readers.emplace_back([&, r]() {
+            int id = tree.registerReader();
+            mt19937 rng(100 + r);
+            long long local = 0, localScanned = 0, localFailures = 0;
+            while (!stop.load(memory_order_relaxed)) {
+                ConcurrentBST::Snapshot snap(tree, id);
+                int lo = (int)(rng() % KEYS), hi = lo + 2000;
+                // ͬһڣɨĽ밴Сһ
+                size_t sum = 0;
+                int prev = lo - 1;
+                bool ordered = true;
+                snap.rangeVisit(lo, hi, [&](int key, uint32_t c) {
+                    ordered = ordered && key > prev && key <= hi && c > 0;
+                    prev = key;
+                    sum += c;
+                });
+                if (!ordered || sum != snap.countInRange(lo, hi)) ++localFailures;
+                if (prev >= lo && !snap.search(prev)) ++localFailures;
+                if (local % 256 == 0 && !validateVersion(snap.rootNode())) ++localFailures;
+                localScanned += (long long)sum;
+                ++local;
+            }
+            tree.unregisterReader(id);
+            snapshots += local;
+            scanned += localScanned;
+            failures += localFailures;
+        });
+    }
+
+    auto start = Clock::now();
+    mt19937 rng(11);
+    while (Clock::now() - start < DURATION) {
+        for (int i = 0; i < 256; ++i, ++writes) {
+            int key = (int)(rng() % KEYS);
+            if (rng() & 1) {
+                tree.insert(key);
+                ++reference[key];
+            }
+            else {
+                bool removed = tree.deleteNode(key);
+                auto it = reference.find(key);
+                if (removed != (it != reference.end())) ++failures;
+                if (removed && --it->second == 0) reference.erase(it);
+            }
+        }
+    }
+    stop = true;
+    for (thread& t : readers) t.join();
+
+    // дͣºհ汾ȫһ
+    int id = tree.registerReader();
+    {
+        ConcurrentBST::Snapshot snap(tree, id);
+        auto it = reference.begin();
+        bool same = validateVersion(snap.rootNode());
+        snap.rangeVisit(INT_MIN, INT_MAX, [&](int key, uint32_t c) {
+            same = same && it != reference.end() && it->first == key && it->second == c;
+            if (it != reference.end()) ++it;
+        });
+        if (!same || it != reference.end()) ++failures;
+    }
+    tree.unregisterReader(id);
+
+    cout << "\nѹԣ1 д + " << READERS << " ߣ" << DURATION.count() / 1000 << " 룩\n";
+    cout << "д: " << writes << "  ߿: " << snapshots << "  ɨ赽ֵ: " << scanned << "\n";
+    cout << "վɽڵ: " << tree.retiredNodes() << "\n";
+    if (failures == 0) cout << ": ͨ\n";
+    else cout << ": ʧܣһ´ " << failures << "\n";
+}
+
+// չԲԣ10^6 һд߳޸ģ
+// ȡ 1/2/4/8/16ÿ 64 βңͳܲ
+void runConcurrentBenchmark() {
+    const int KEYS = 1 << 22;
+    const int readerCounts[] = { 1, 2, 4, 8, 16 };
+    const chrono::milliseconds DURATION(1000);
+    const int PER_SNAPSHOT = 64;
+
+    ConcurrentBST tree;
+    {
+        mt19937 rng(2024);
+        vector<int> data(1000000);
+        for (int& v : data) v = (int)(rng() % KEYS);
+        tree.build(data);
+    }
+
+    cout << "\nӲ߳: " << thread::hardware_concurrency() << "\n";
+    cout << "   (M/s)   ÿ(M/s)   д(K/s)\n";
+    for (int readers : readerCounts) {
+        atomic<bool> stop(false);
+        atomic<long long> lookups(0), found(0);
+        vector<thread> threads;
+        for (int r = 0; r < readers; ++r) {
+            threads.emplace_back([&, r]() {
+                int id = tree.registerReader();
+                mt19937 rng(r + 1);
+                long long local = 0, hits = 0;
+                while (!stop.load(memory_order_relaxed)) {
+                    ConcurrentBST::Snapshot snap(tree, id);
+                    for (int i = 0; i < PER_SNAPSHOT; ++i) hits += snap.search((int)(rng() % KEYS)) ? 1 : 0;
+                    local += PER_SNAPSHOT;
+                }
+                tree.unregisterReader(id);
+                lookups += local;
+                found += hits;
+            });
+        }
+
+        mt19937 rng(readers);
+        long long writes = 0;
+        auto start = Clock::now();
+        while (Clock::now() - start < DURATION) {
+            for (int i = 0; i < 64; ++i, ++writes) {
+                int key = (int)(rng() % KEYS);
+                if (rng() & 1) tree.insert(key);
+                else tree.deleteNode(key);
+            }
+        }
+        stop = true;
+        for (thread& t : threads) t.join();
+        double sec = chrono::duration<double>(Clock::now() - start).count();
+        benchmarkSink = found;
+
+        cout << left << setw(9) << readers << right << fixed << setprecision(2)
+            << setw(10) << lookups / sec / 1e6 << setw(14) << lookups / sec / 1e6 / readers
+            << setprecision(1) << setw(14) << writes / sec / 1e3 << "\n";
+        cout.unsetf(ios::fixed);
+    }
+}
+
+//  N
+int readCount() {
     int N;
     while (true) {
         cout << "Ҫɵ N (N > 20): ";
         cin >> N;
-        if (N > 20) break;
+        if (N > 20) return N;
         cout << "ЧN  20" << endl;
     }
+}
+
+// һдڵֵ
+template <class Exists>
+int readExistingKey(Exists exists) {
+    int deleteKey;
+    while (true) {
+        cout << "\nҪɾ: ";
+        cin >> deleteKey;
+        if (exists(deleteKey)) {
+            return deleteKey;
+        }
+        else {
+            cout << "вڸݣڵֵ\n";
+        }
+    }
+}
 
-    TreeNode* root = NULL;
+// ɾһڵٱ
+template <class Node>
+void runDemo() {
+    int N = readCount();
+
+    Node* root = NULL;
     vector<int> rawData;
 
     cout << "\n " << N << "  (Χ 1-100)...\n";
@@ -166,24 +643,91 @@ int main() {
     selectChoice(root);
 
     // ɾ
-    int deleteKey;
-    while (true) {
-        cout << "\nҪɾ: ";
-        cin >> deleteKey;
-        if (search(root, deleteKey)) {
-            break;
-        }
-        else {
-            cout << "вڸݣڵֵ\n";
-        }
-    }
-
+    int deleteKey = readExistingKey([&](int key) { return search(root, key); });
     root = deleteNode(root, deleteKey);
     cout << "ɾڵ: " << deleteKey << endl;
 
     // ڶαѡ
     cout << "\n=== ɾĶ ===";
     selectChoice(root);
+    destroyTree(root);
+}
+
+// ؼģʽͬϣظֵֻӼ
+void runMultisetDemo() {
+    int N = readCount();
+
+    vector<int> rawData;
+    cout << "\n " << N << "  (Χ 1-100)...\n";
+    cout << "ԭʼ: ";
+    for (int i = 0; i < N; ++i) {
+        int num = rand() % 100 + 1;
+        rawData.push_back(num);
+        cout << num << " ";
+    }
+    MultisetBST tree;
+    tree.build(rawData);    // һκ
+    cout << "\n\n=== ɣ" << tree.size() << " ֵ" << tree.distinct() << " ڵ㣩===" << endl;
+
+    selectChoice(tree);
+
+    // ˳ͳƣҪ
+    cout << "\nСֵ: " << tree.select(0) << "  λ: " << tree.select(tree.size() / 2)
+        << "  ֵ: " << tree.select(tree.size() - 1) << endl;
+    int lo, hi;
+    cout << "ѯ½Ͻ (lo hi): ";
+    cin >> lo >> hi;
+    cout << " [" << lo << ", " << hi << "] ڹ " << tree.countInRange(lo, hi) << " ֵ"
+        << "С " << lo << "  " << tree.rank(lo) << " \n";
+    cout << "ڵֵ(): ";
+    for (MultisetBST::Entry e : tree.range(lo, hi)) cout << e.key << "(" << e.count << ") ";
+    cout << endl;
+
+    int deleteKey = readExistingKey([&](int key) { return tree.search(key); });
+    tree.deleteNode(deleteKey);
+    cout << "ɾһ " << deleteKey << "ʣ " << tree.count(deleteKey) << " " << endl;
+
+    cout << "\n=== ɾĶ ===";
+    selectChoice(tree);
+}
+
+int main() {
+    srand((unsigned)time(0)); // 
+
+    int mode;
+    cout << "ѡģʽ:\n";
+    cout << "1. ͨ\n";
+    cout << "2. AVL ƽ\n";
+    cout << "3. ܲԣ10^6 \n";
+    cout << "4. ؼظֵ\n";
+    cout << "5. ܲԣָ / ؼ / 飩\n";
+    cout << "6. ѹԣ1 д + \n";
+    cout << "7. չԲԣ1-16 ߣ\n";
+    cout << "ѡ (1-7): ";
+    cin >> mode;
+
+    switch (mode) {
+    case 2:
+        runDemo<AVLNode>();
+        break;
+    case 3:
+        runBenchmark();
+        break;
+    case 4:
+        runMultisetDemo();
+        break;
+    case 5:
+        runFrozenBenchmark();
+        break;
+    case 6:
+        runConcurrentStressTest();
+        break;
+    case 7:
+        runConcurrentBenchmark();
+        break;
+    default:
+        runDemo<TreeNode>();
+    }
 
     cout << "\n\n";
     system("pause"); // ֱֹӹر
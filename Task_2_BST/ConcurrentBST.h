@@ -0,0 +1,352 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+// ΪĶؼAVL ƽ⣬дʱƣ
+// ѷĽڵ޸ģдز·Ƴ½ڵ㣨O(log n) 
+// ɰ汾úԭӵط¸
+// ȡʱֻһθָ룬֮󿴵ľһ̵汾ȴдߡ
+// 滻ľɽڵ㰴"Ԫ"ӳͷţÿԼĲλǼȡʱļԪ
+// дֻͷűлԾߵǼǵļԪľɽڵ
+class ConcurrentBST {
+public:
+    static const int MAX_READERS = 64;
+
+    struct Node {
+        int key;
+        uint32_t count;     // ִ
+        int height;
+        uint32_t size;      // еԪظ
+        uint64_t stamp;     // Ǵ޸ĵı
+        const Node* left;
+        const Node* right;
+    };
+
+private:
+    static const int MAX_HEIGHT = 64;
+    static const uint64_t IDLE = ~0ULL;
+
+    struct alignas(64) ReaderSlot {     // ÿ۶ռһУ֮以
+        atomic<uint64_t> epoch{ IDLE };
+        atomic<bool> used{ false };
+    };
+
+    struct Retired {
+        uint64_t epoch;     // üԪʼʱЩڵѲɴ
+        vector<const Node*> nodes;
+    };
+
+    atomic<const Node*> root{ NULL };
+    atomic<uint64_t> globalEpoch{ 1 };
+    ReaderSlot slots[MAX_READERS];
+
+    // ֻд߷
+    mutex writeLock;
+    uint64_t stamp = 0;
+    vector<const Node*> pending;    // ޸滻ľɽڵ
+    vector<Retired> retired;
+
+    static int height(const Node* n) { return n ? n->height : 0; }
+    static uint32_t size(const Node* n) { return n ? n->size : 0; }
+
+    const Node* make(int key, uint32_t count, const Node* left, const Node* right) {
+        Node* n = new Node;
+        n->key = key;
+        n->count = count;
+        n->height = max(height(left), height(right)) + 1;
+        n->size = size(left) + size(right) + count;
+        n->stamp = stamp;
+        n->left = left;
+        n->right = right;
+        return n;
+    }
+
+    // һڵ㣺½δֱͷţѷĵȶ뿪ͷ
+    void discard(const Node* n) {
+        if (n->stamp == stamp) delete n;
+        else pending.push_back(n);
+    }
+
+    //  (key, count, left, right) ڵ㲢ָƽ⣨Ҹ߶ȲΪ 2
+    const Node* balance(int key, uint32_t count, const Node* left, const Node* right) {
+        int hl = height(left), hr = height(right);
+        if (hl > hr + 1) {
+            const Node* l = left;
+            if (height(l->left) >= height(l->right)) {
+                const Node* r = make(l->key, l->count, l->left, make(key, count, l->right, right));
+                discard(l);
+                return r;
+            }
+            const Node* lr = l->right;
+            const Node* r = make(lr->key, lr->count, make(l->key, l->count, l->left, lr->left), make(key, count, lr->right, right));
+            discard(l);
+            discard(lr);
+            return r;
+        }
+        if (hr > hl + 1) {
+            const Node* rn = right;
+            if (height(rn->right) >= height(rn->left)) {
+                const Node* r = make(rn->key, rn->count, make(key, count, left, rn->left), rn->right);
+                discard(rn);
+                return r;
+            }
+            const Node* rl = rn->left;
+            const Node* r = make(rl->key, rl->count, make(key, count, left, rl->left), make(rn->key, rn->count, rl->right, rn->right));
+            discard(rn);
+            discard(rl);
+            return r;
+        }
+        return make(key, count, left, right);
+    }
+
+    // ޸ĺݹΪ O(log n)
+    const Node* insertAt(const Node* n, int key) {
+        if (n == NULL) return make(key, 1, NULL, NULL);
+        const Node* r;
+        if (key == n->key) r = make(key, n->count + 1, n->left, n->right);
+        else if (key < n->key) r = balance(n->key, n->count, insertAt(n->left, key), n->right);
+        else r = balance(n->key, n->count, n->left, insertAt(n->right, key));
+        discard(n);
+        return r;
+    }
+
+    const Node* removeMin(const Node* n) {
+        if (n->left == NULL) {
+            const Node* r = n->right;
+            discard(n);
+            return r;
+        }
+        const Node* r = balance(n->key, n->count, removeMin(n->left), n->right);
+        discard(n);
+        return r;
+    }
+
+    // ǰȷ key 
+    const Node* eraseAt(const Node* n, int key) {
+        const Node* r;
+        if (key < n->key) {
+            r = balance(n->key, n->count, eraseAt(n->left, key), n->right);
+        }
+        else if (key > n->key) {
+            r = balance(n->key, n->count, n->left, eraseAt(n->right, key));
+        }
+        else if (n->count > 1) {
+            r = make(key, n->count - 1, n->left, n->right);
+        }
+        else if (n->left == NULL || n->right == NULL) {
+            r = n->left ? n->left : n->right;
+        }
+        else {
+            // ӣСڵ㶥
+            const Node* m = n->right;
+            while (m->left) m = m->left;
+            int mk = m->key;
+            uint32_t mc = m->count;
+            r = balance(mk, mc, n->left, removeMin(n->right));
+        }
+        discard(n);
+        return r;
+    }
+
+    const Node* buildRange(const int* sorted, const size_t* starts, size_t lo, size_t hi) {
+        if (lo >= hi) return NULL;
+        size_t mid = lo + (hi - lo) / 2;
+        const Node* l = buildRange(sorted, starts, lo, mid);
+        const Node* r = buildRange(sorted, starts, mid + 1, hi);
+        return make(sorted[starts[mid]], (uint32_t)(starts[mid + 1] - starts[mid]), l, r);
+    }
+
+    // Ľڵ out
+    static void collect(const Node* n, vector<const Node*>& out) {
+        vector<const Node*> stack;
+        if (n) stack.push_back(n);
+        while (!stack.empty()) {
+            const Node* x = stack.back();
+            stack.pop_back();
+            out.push_back(x);
+            if (x->left) stack.push_back(x->left);
+            if (x->right) stack.push_back(x->right);
+        }
+    }
+
+    // ¸ѱ滻Ľڵ¼Ԫͷ޶߿ɼľɽڵ
+    void publish(const Node* newRoot) {
+        root.store(newRoot, memory_order_seq_cst);
+        uint64_t e = globalEpoch.fetch_add(1, memory_order_seq_cst) + 1;
+        if (!pending.empty()) {
+            retired.push_back(Retired{ e, move(pending) });
+            pending.clear();
+        }
+        reclaim();
+    }
+
+    void reclaim() {
+        uint64_t oldest = IDLE;
+        for (const ReaderSlot& s : slots) oldest = min(oldest, s.epoch.load(memory_order_seq_cst));
+        size_t done = 0;
+        while (done < retired.size() && retired[done].epoch <= oldest) {
+            for (const Node* n : retired[done].nodes) delete n;
+            ++done;
+        }
+        retired.erase(retired.begin(), retired.begin() + done);
+    }
+
+public:
+    // ߿գʱǼǼԪȡʱע
+    // մڼ俴İ汾䣬еĽڵҲᱻͷ
+    class Snapshot {
+    private:
+        ReaderSlot* slot;
+        const Node* top;
+
+        size_t countBelow(int key, bool inclusive) const {
+            size_t n = 0;
+            const Node* x = top;
+            while (x) {
+                if (key < x->key || (key == x->key && !inclusive)) {
+                    x = x->left;
+                }
+                else {
+                    n += ConcurrentBST::size(x->left) + x->count;
+                    if (key == x->key) break;
+                    x = x->right;
+                }
+            }
+            return n;
+        }
+
+    public:
+        Snapshot(ConcurrentBST& tree, int reader) : slot(&tree.slots[reader]) {
+            // ȵǼٶдҪôǼǶɽڵ㣬Ҫôѷ¸Ƕ
+            slot->epoch.store(tree.globalEpoch.load(memory_order_seq_cst), memory_order_seq_cst);
+            top = tree.root.load(memory_order_seq_cst);
+        }
+
+        ~Snapshot() {
+            slot->epoch.store(IDLE, memory_order_release);
+        }
+
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+
+        const Node* rootNode() const { return top; }
+
+        bool search(int key) const {
+            const Node* x = top;
+            while (x && x->key != key) x = key < x->key ? x->left : x->right;
+            return x != NULL;
+        }
+
+        size_t size() const { return ConcurrentBST::size(top); }
+        int height() const { return ConcurrentBST::height(top); }
+        size_t rank(int key) const { return countBelow(key, false); }
+
+        size_t countInRange(int lo, int hi) const {
+            if (lo > hi) return 0;
+            return countBelow(hi, true) - countBelow(lo, false);
+        }
+
+        //  [lo, hi] ڵÿڵ visit(key, count)O(log n + )
+        template <class Visit>
+        void rangeVisit(int lo, int hi, Visit&& visit) const {
+            const Node* stack[MAX_HEIGHT];
+            int depth = 0;
+            const Node* x = top;
+            while (x) {
+                if (x->key < lo) {
+                    x = x->right;
+                }
+                else {
+                    stack[depth++] = x;
+                    x = x->left;
+                }
+            }
+            while (depth > 0) {
+                const Node* n = stack[--depth];
+                if (n->key > hi) break;
+                visit(n->key, n->count);
+                for (x = n->right; x; x = x->left) stack[depth++] = x;
+            }
+        }
+    };
+
+    ConcurrentBST() {}
+
+    ConcurrentBST(const ConcurrentBST&) = delete;
+    ConcurrentBST& operator=(const ConcurrentBST&) = delete;
+
+    // ʱж
+    ~ConcurrentBST() {
+        vector<const Node*> all;
+        collect(root.load(), all);
+        for (const Node* n : all) delete n;
+        for (Retired& r : retired)
+            for (const Node* n : r.nodes) delete n;
+    }
+
+    // Ϊ̷߳һλλþʱ -1߳̽ǰ unregisterReader
+    int registerReader() {
+        for (int i = 0; i < MAX_READERS; ++i) {
+            bool expected = false;
+            if (slots[i].used.compare_exchange_strong(expected, true)) return i;
+        }
+        return -1;
+    }
+
+    void unregisterReader(int reader) {
+        slots[reader].epoch.store(IDLE, memory_order_release);
+        slots[reader].used.store(false, memory_order_release);
+    }
+
+    Snapshot snapshot(int reader) {
+        return Snapshot(*this, reader);
+    }
+
+    // дͬһʱֻһдЧ߲Ӱ
+    void insert(int key) {
+        lock_guard<mutex> guard(writeLock);
+        ++stamp;
+        publish(insertAt(root.load(memory_order_relaxed), key));
+    }
+
+    // ɾһֵΪ key Ԫأʱ false
+    bool deleteNode(int key) {
+        lock_guard<mutex> guard(writeLock);
+        const Node* r = root.load(memory_order_relaxed);
+        const Node* x = r;
+        while (x && x->key != key) x = key < x->key ? x->left : x->right;
+        if (x == NULL) return false;
+        ++stamp;
+        publish(eraseAt(r, key));
+        return true;
+    }
+
+    //  data 滻ǰݣ O(n) ȫƽ°汾ٷ
+    void build(vector<int> data) {
+        sort(data.begin(), data.end());
+        vector<size_t> starts;
+        for (size_t i = 0; i < data.size(); ++i)
+            if (i == 0 || data[i] != data[i - 1]) starts.push_back(i);
+        size_t distinct = starts.size();
+        starts.push_back(data.size());
+
+        lock_guard<mutex> guard(writeLock);
+        ++stamp;
+        collect(root.load(memory_order_relaxed), pending);
+        publish(buildRange(data.data(), starts.data(), 0, distinct));
+    }
+
+    // δͷŵľɽڵڳпյĶ߻
+    size_t retiredNodes() {
+        lock_guard<mutex> guard(writeLock);
+        size_t n = 0;
+        for (const Retired& r : retired) n += r.nodes.size();
+        return n;
+    }
+};
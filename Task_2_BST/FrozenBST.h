@@ -0,0 +1,127 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "MultisetBST.h"
+
+#if defined(_MSC_VER)
+#include <xmmintrin.h>
+#define BST_PREFETCH(p) _mm_prefetch((const char*)(p), _MM_HINT_T0)
+#else
+#define BST_PREFETCH(p) __builtin_prefetch(p)
+#endif
+
+using namespace std;
+
+// ֻᣩ򼯺ϣ EytzingerBFS˳ֵһƽ̹
+// ± k Һ 2k2k+1ʱûָ롢ûз֧Ԥʧܣ
+// ÿֻһαȽϲѽӵ±ϣͬʱԤȡ 4 ֮ 16 ѡһ 64 ֽڻУ
+// ú޸ģʺϽһΡܶεĳ
+class FrozenBST {
+private:
+    vector<int> storage;        // һУ keys 뵽 64 ֽ
+    int* keys;                  // keys[1..n]keys[0] 
+    vector<uint32_t> counts;    //  keys ͬ±꣺ִ
+    size_t n;
+    size_t total;
+
+    // ΰѵ i СֵŽʽȫO(n)
+    template <class Source>
+    void layout(Source next) {
+        storage.assign(n + 1 + 16, 0);
+        uintptr_t addr = (uintptr_t)storage.data();
+        keys = storage.data() + ((64 - addr % 64) % 64) / sizeof(int);
+        counts.assign(n + 1, 0);
+
+        size_t k = 1;
+        while (2 * k <= n) k *= 2;
+        for (size_t i = 0; i < n; ++i) {
+            next(keys[k], counts[k]);
+            if (2 * k + 1 <= n) {       // Ľڵ
+                k = 2 * k + 1;
+                while (2 * k <= n) k *= 2;
+            }
+            else {                      // ϣֱ
+                while (k & 1) k >>= 1;
+                k >>= 1;
+            }
+        }
+    }
+
+    // һС key λãûʱ 0
+    size_t lowerBound(int key) const {
+        size_t k = 1;
+        while (k <= n) {
+            BST_PREFETCH(keys + k * 16);
+            k = 2 * k + (keys[k] < key);
+        }
+        // һ֮ЩҶҪȥĩβ 1 Ǹ 0
+        return k >> (countr_one(k) + 1);
+    }
+
+public:
+    FrozenBST() : keys(NULL), n(0), total(0) {}
+
+    FrozenBST(const FrozenBST&) = delete;
+    FrozenBST& operator=(const FrozenBST&) = delete;
+
+    // źݽظֵϲ
+    void buildFromSorted(const int* sorted, size_t count) {
+        n = 0;
+        for (size_t i = 0; i < count; ++i) n += (i == 0 || sorted[i] != sorted[i - 1]) ? 1 : 0;
+        total = count;
+        size_t pos = 0;
+        layout([&](int& key, uint32_t& c) {
+            size_t end = pos + 1;
+            while (end < count && sorted[end] == sorted[pos]) ++end;
+            key = sorted[pos];
+            c = (uint32_t)(end - pos);
+            pos = end;
+        });
+    }
+
+    // һκ
+    void build(vector<int> data) {
+        sort(data.begin(), data.end());
+        buildFromSorted(data.data(), data.size());
+    }
+
+    // һöؼ
+    void build(const MultisetBST& tree) {
+        vector<MultisetBST::Entry> entries;
+        entries.reserve(tree.distinct());
+        tree.inOrderCounted([&](int key, uint32_t c) { entries.push_back(MultisetBST::Entry{ key, c }); });
+        n = entries.size();
+        total = tree.size();
+        size_t pos = 0;
+        layout([&](int& key, uint32_t& c) {
+            key = entries[pos].key;
+            c = entries[pos].count;
+            ++pos;
+        });
+    }
+
+    bool search(int key) const {
+        size_t k = lowerBound(key);
+        return k != 0 && keys[k] == key;
+    }
+
+    uint32_t count(int key) const {
+        size_t k = lowerBound(key);
+        return k != 0 && keys[k] == key ? counts[k] : 0;
+    }
+
+    size_t size() const {
+        return total;
+    }
+
+    size_t distinct() const {
+        return n;
+    }
+
+    size_t memoryBytes() const {
+        return storage.capacity() * sizeof(int) + counts.capacity() * sizeof(uint32_t);
+    }
+};
@@ -0,0 +1,455 @@
+#pragma once
+#include <cstddef>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+// ʽؼAVL ƽ⣩
+// ֵֻͬռһڵ㣬ڵ¼ִظֻѴһ
+// ڵһ飨arenaУ 32 λ±ָã
+// ɾճĽڵڿϹ´β븴á
+// ˽ڵڴͲʱĻδֻ治ֵͬĸܴ޹ء
+// ÿڵ㻹¼еԪظݴ֧ O(log n) 
+//  rank k С select countInRangeԼ
+class MultisetBST {
+public:
+    typedef uint32_t Index;
+
+private:
+    static const Index NIL = 0;     // 0 Žڵڱ߶ 0
+    static const int MAX_HEIGHT = 64;
+
+    struct Node {
+        int key;
+        uint32_t count;     // ִΪ 1
+        Index left;
+        Index right;        // нڵ right ɿ
+        int height;         // ҶΪ 1
+        uint32_t size;      // еԪظ
+    };
+
+    vector<Node> nodes;
+    Index root;
+    Index freeHead;         // ͷ
+    size_t total;           // ظԪ
+    size_t distinctCount;
+
+    Index allocate(int key) {
+        Index i;
+        if (freeHead != NIL) {
+            i = freeHead;
+            freeHead = nodes[i].right;
+        }
+        else {
+            i = (Index)nodes.size();
+            nodes.push_back(Node());
+        }
+        nodes[i] = Node{ key, 1, NIL, NIL, 1, 1 };
+        return i;
+    }
+
+    void release(Index i) {
+        nodes[i].right = freeHead;
+        freeHead = i;
+    }
+
+    // ɺ¼߶С
+    void update(Index i) {
+        Node& n = nodes[i];
+        int l = nodes[n.left].height, r = nodes[n.right].height;
+        n.height = (l > r ? l : r) + 1;
+        n.size = nodes[n.left].size + nodes[n.right].size + n.count;
+    }
+
+    Index rotateRight(Index i) {
+        Index l = nodes[i].left;
+        nodes[i].left = nodes[l].right;
+        nodes[l].right = i;
+        update(i);
+        update(l);
+        return l;
+    }
+
+    Index rotateLeft(Index i) {
+        Index r = nodes[i].right;
+        nodes[i].right = nodes[r].left;
+        nodes[r].left = i;
+        update(i);
+        update(r);
+        return r;
+    }
+
+    Index rebalance(Index i) {
+        update(i);
+        Node& n = nodes[i];
+        int balance = nodes[n.left].height - nodes[n.right].height;
+        if (balance > 1) {
+            if (nodes[nodes[n.left].left].height < nodes[nodes[n.left].right].height)
+                n.left = rotateLeft(n.left);
+            return rotateRight(i);
+        }
+        if (balance < -1) {
+            if (nodes[nodes[n.right].right].height < nodes[nodes[n.right].left].height)
+                n.right = rotateRight(n.right);
+            return rotateLeft(i);
+        }
+        return i;
+    }
+
+    // Ѹڵ parentNIL ʾָ oldChild ±Ϊ newChild
+    void replaceChild(Index parent, Index oldChild, Index newChild) {
+        if (parent == NIL) root = newChild;
+        else if (nodes[parent].left == oldChild) nodes[parent].left = newChild;
+        else nodes[parent].right = newChild;
+    }
+
+    // ·¶ϸСָƽ⣻·ֻ±꣬arena ҲʧЧ
+    void rebalancePath(const Index path[], int depth) {
+        while (depth-- > 0) {
+            Index old = path[depth];
+            Index now = rebalance(old);
+            if (now != old) replaceChild(depth > 0 ? path[depth - 1] : NIL, old, now);
+        }
+    }
+
+    Index find(int key) const {
+        const Node* base = nodes.data();
+        Index i = root;
+        while (i != NIL && base[i].key != key) i = key < base[i].key ? base[i].left : base[i].right;
+        return i;
+    }
+
+    // ± [lo, hi) ѰֵźõĽڵȫƽݹΪ log2(n)
+    Index link(Index lo, Index hi) {
+        if (lo >= hi) return NIL;
+        Index mid = lo + (hi - lo) / 2;
+        nodes[mid].left = link(lo, mid);
+        nodes[mid].right = link(mid + 1, hi);
+        update(mid);
+        return mid;
+    }
+
+    // С keyinclusive ʱΪСڵڣԪظ
+    size_t countBelow(int key, bool inclusive) const {
+        const Node* base = nodes.data();
+        size_t n = 0;
+        Index i = root;
+        while (i != NIL) {
+            const Node& node = base[i];
+            if (key < node.key || (key == node.key && !inclusive)) {
+                i = node.left;
+            }
+            else {
+                n += base[node.left].size + node.count;
+                if (key == node.key) break;
+                i = node.right;
+            }
+        }
+        return n;
+    }
+
+public:
+    // ʱһһִֵͬ
+    struct Entry {
+        int key;
+        uint32_t count;
+    };
+
+    //  [lo, hi] ڵĽڵ㣻ջδʵġֵС lo ȣȲ
+    class RangeIterator {
+    private:
+        const MultisetBST* tree;
+        Index stack[MAX_HEIGHT];
+        int top;
+        int hi;
+
+        void pushLeft(Index i) {
+            for (; i != NIL; i = tree->nodes[i].left) stack[top++] = i;
+        }
+
+        // ջ hi ʱ
+        void trim() {
+            if (top > 0 && tree->nodes[stack[top - 1]].key > hi) top = 0;
+        }
+
+    public:
+        RangeIterator() : tree(NULL), top(0), hi(0) {}
+
+        RangeIterator(const MultisetBST* t, int lo, int hiKey) : tree(t), top(0), hi(hiKey) {
+            //  lower_bound ͬ½ֵֻ̣С lo Ľڵջ
+            Index i = t->root;
+            while (i != NIL) {
+                if (t->nodes[i].key < lo) {
+                    i = t->nodes[i].right;
+                }
+                else {
+                    stack[top++] = i;
+                    i = t->nodes[i].left;
+                }
+            }
+            trim();
+        }
+
+        Entry operator*() const {
+            const Node& n = tree->nodes[stack[top - 1]];
+            return Entry{ n.key, n.count };
+        }
+
+        RangeIterator& operator++() {
+            Index i = stack[--top];
+            pushLeft(tree->nodes[i].right);
+            trim();
+            return *this;
+        }
+
+        // ֻ end() Ƚ
+        bool operator==(const RangeIterator& o) const { return (top == 0) == (o.top == 0); }
+        bool operator!=(const RangeIterator& o) const { return !(*this == o); }
+    };
+
+    struct Range {
+        const MultisetBST* tree;
+        int lo;
+        int hi;
+        RangeIterator begin() const { return RangeIterator(tree, lo, hi); }
+        RangeIterator end() const { return RangeIterator(); }
+    };
+
+    MultisetBST() : nodes(1, Node{ 0, 0, NIL, NIL, 0, 0 }), root(NIL), freeHead(NIL), total(0), distinctCount(0) {}
+
+    // Ԥ n ֵͬĿռ
+    void reserve(size_t n) {
+        nodes.reserve(n + 1);
+    }
+
+    // źһνȫƽO(n)ԭݱ
+    // ڵ㰴ֵ˳ţ˳ڴ
+    void buildFromSorted(const int* sorted, size_t n) {
+        clear();
+        size_t runs = 0;
+        for (size_t i = 0; i < n; ++i) runs += (i == 0 || sorted[i] != sorted[i - 1]) ? 1 : 0;
+        nodes.reserve(runs + 1);
+        for (size_t i = 0; i < n;) {
+            size_t j = i + 1;
+            while (j < n && sorted[j] == sorted[i]) ++j;
+            nodes.push_back(Node{ sorted[i], (uint32_t)(j - i), NIL, NIL, 1, 0 });
+            i = j;
+        }
+        total = n;
+        distinctCount = nodes.size() - 1;
+        root = link(1, (Index)nodes.size());
+    }
+
+    // һκO(n log n)  O(n) Ľ
+    void build(vector<int> data) {
+        sort(data.begin(), data.end());
+        buildFromSorted(data.data(), data.size());
+    }
+
+    // һֵѴʱֻѴһ
+    void insert(int key) {
+        Index path[MAX_HEIGHT];
+        int depth = 0;
+        Index i = root;
+        while (i != NIL) {
+            Node& n = nodes[i];
+            if (key == n.key) {
+                ++n.count;
+                ++n.size;
+                for (int d = 0; d < depth; ++d) ++nodes[path[d]].size;
+                ++total;
+                return;
+            }
+            path[depth++] = i;
+            i = key < n.key ? n.left : n.right;
+        }
+
+        Index fresh = allocate(key);
+        if (depth == 0) root = fresh;
+        else if (key < nodes[path[depth - 1]].key) nodes[path[depth - 1]].left = fresh;
+        else nodes[path[depth - 1]].right = fresh;
+        ++total;
+        ++distinctCount;
+        rebalancePath(path, depth);
+    }
+
+    // ɾһֵΪ key Ԫأһ 0 ʱսڵ㣻ʱ false
+    bool deleteNode(int key) {
+        Index path[MAX_HEIGHT];
+        int depth = 0;
+        Index i = root;
+        while (i != NIL && nodes[i].key != key) {
+            path[depth++] = i;
+            i = key < nodes[i].key ? nodes[i].left : nodes[i].right;
+        }
+        if (i == NIL) return false;
+
+        --total;
+        if (--nodes[i].count > 0) {
+            --nodes[i].size;
+            for (int d = 0; d < depth; ++d) --nodes[path[d]].size;
+            return true;
+        }
+
+        --distinctCount;
+        Index parent = depth > 0 ? path[depth - 1] : NIL;
+        if (nodes[i].left == NIL || nodes[i].right == NIL) {
+            replaceChild(parent, i, nodes[i].left != NIL ? nodes[i].left : nodes[i].right);
+            release(i);
+        }
+        else {
+            // ӽڵ㣺̵ֵʹժ
+            path[depth++] = i;
+            Index succParent = i;
+            Index succ = nodes[i].right;
+            while (nodes[succ].left != NIL) {
+                path[depth++] = succ;
+                succParent = succ;
+                succ = nodes[succ].left;
+            }
+            nodes[i].key = nodes[succ].key;
+            nodes[i].count = nodes[succ].count;
+            replaceChild(succParent, succ, nodes[succ].right);
+            release(succ);
+        }
+        rebalancePath(path, depth);
+        return true;
+    }
+
+    bool search(int key) const {
+        return find(key) != NIL;
+    }
+
+    // key ֵĴ
+    uint32_t count(int key) const {
+        Index i = find(key);
+        return i == NIL ? 0 : nodes[i].count;
+    }
+
+    // Ԫظ
+    size_t size() const {
+        return total;
+    }
+
+    // ֵͬĸڵ
+    size_t distinct() const {
+        return distinctCount;
+    }
+
+    bool empty() const {
+        return total == 0;
+    }
+
+    int height() const {
+        return nodes[root].height;
+    }
+
+    // С key Ԫظ key һγʱ 0 ±꣩O(log n)
+    size_t rank(int key) const {
+        return countBelow(key, false);
+    }
+
+    //  k СԪأk  0 𣬺ظҪ k < size()O(log n)
+    int select(size_t k) const {
+        const Node* base = nodes.data();
+        Index i = root;
+        while (true) {
+            const Node& n = base[i];
+            size_t leftSize = base[n.left].size;
+            if (k < leftSize) {
+                i = n.left;
+            }
+            else if (k < leftSize + n.count) {
+                return n.key;
+            }
+            else {
+                k -= leftSize + n.count;
+                i = n.right;
+            }
+        }
+    }
+
+    // lo <= ֵ <= hi ԪظO(log n)
+    size_t countInRange(int lo, int hi) const {
+        if (lo > hi) return 0;
+        return countBelow(hi, true) - countBelow(lo, false);
+    }
+
+    // [lo, hi] ڵĽڵ㣬for (auto e : tree.range(lo, hi)) ...O(log n + )
+    Range range(int lo, int hi) const {
+        return Range{ this, lo, hi };
+    }
+
+    // arena ռõֽнڵ㣩
+    size_t memoryBytes() const {
+        return nodes.capacity() * sizeof(Node);
+    }
+
+    void clear() {
+        nodes.resize(1);
+        root = NIL;
+        freeHead = NIL;
+        total = 0;
+        distinctCount = 0;
+    }
+
+    // ÿڵ visit(key, count)
+    template <class Visit>
+    void inOrderCounted(Visit&& visit) const {
+        Index stack[MAX_HEIGHT];
+        int top = 0;
+        Index i = root;
+        while (i != NIL || top > 0) {
+            while (i != NIL) {
+                stack[top++] = i;
+                i = nodes[i].left;
+            }
+            i = stack[--top];
+            visit(nodes[i].key, nodes[i].count);
+            i = nodes[i].right;
+        }
+    }
+
+    // ֱͨһ£ֵּξ͵ü visit(key)
+    template <class Visit>
+    void inOrderVisit(Visit&& visit) const {
+        inOrderCounted([&](int key, uint32_t count) {
+            for (uint32_t c = 0; c < count; ++c) visit(key);
+        });
+    }
+
+    template <class Visit>
+    void preOrderVisit(Visit&& visit) const {
+        Index stack[MAX_HEIGHT + 1];
+        int top = 0;
+        if (root != NIL) stack[top++] = root;
+        while (top > 0) {
+            const Node& n = nodes[stack[--top]];
+            for (uint32_t c = 0; c < n.count; ++c) visit(n.key);
+            if (n.right != NIL) stack[top++] = n.right;
+            if (n.left != NIL) stack[top++] = n.left;
+        }
+    }
+
+    template <class Visit>
+    void postOrderVisit(Visit&& visit) const {
+        Index stack[MAX_HEIGHT];
+        int top = 0;
+        Index i = root, last = NIL;
+        while (i != NIL || top > 0) {
+            while (i != NIL) {
+                stack[top++] = i;
+                i = nodes[i].left;
+            }
+            const Node& n = nodes[stack[top - 1]];
+            if (n.right != NIL && n.right != last) {
+                i = n.right;
+                continue;
+            }
+            for (uint32_t c = 0; c < n.count; ++c) visit(n.key);
+            last = stack[--top];
+        }
+    }
+};
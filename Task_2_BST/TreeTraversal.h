@@ -0,0 +1,190 @@
+#pragma once
+#include <charconv>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+using namespace std;
+
+// ͨñκδ val / left / right ĽڵͣTreeNodeAVLNode
+// ȫΪʵ֣Ҳջÿһڵһ visit(val)
+
+// ǰ ( ->  -> )ʽջ
+template <class Node, class Visit>
+void preOrderVisit(Node* root, Visit&& visit) {
+    vector<Node*> stack;
+    if (root) stack.push_back(root);
+    while (!stack.empty()) {
+        Node* node = stack.back();
+        stack.pop_back();
+        visit(node->val);
+        if (node->right) stack.push_back(node->right);  // Һջ
+        if (node->left) stack.push_back(node->left);
+    }
+}
+
+//  ( ->  -> )ʽջ
+template <class Node, class Visit>
+void inOrderVisit(Node* root, Visit&& visit) {
+    vector<Node*> stack;
+    Node* node = root;
+    while (node || !stack.empty()) {
+        while (node) {
+            stack.push_back(node);
+            node = node->left;
+        }
+        node = stack.back();
+        stack.pop_back();
+        visit(node->val);
+        node = node->right;
+    }
+}
+
+//  ( ->  -> )ʽջ + һʵĽڵ
+template <class Node, class Visit>
+void postOrderVisit(Node* root, Visit&& visit) {
+    vector<Node*> stack;
+    Node* node = root;
+    Node* last = NULL;
+    while (node || !stack.empty()) {
+        while (node) {
+            stack.push_back(node);
+            node = node->left;
+        }
+        Node* top = stack.back();
+        if (top->right && top->right != last) {     // û߹
+            node = top->right;
+            continue;
+        }
+        visit(top->val);
+        last = top;
+        stack.pop_back();
+    }
+}
+
+// Morris ҽڵĿָռ O(1)
+// лʱ޸ָ룬ʱȫԭڼ䲻̶߳
+template <class Node, class Visit>
+void morrisInOrder(Node* root, Visit&& visit) {
+    Node* node = root;
+    while (node) {
+        if (node->left == NULL) {
+            visit(node->val);
+            node = node->right;
+            continue;
+        }
+        Node* pred = node->left;
+        while (pred->right && pred->right != node) pred = pred->right;
+        if (pred->right == NULL) {  // һε
+            pred->right = node;
+            node = node->left;
+        }
+        else {                      // ꣬
+            pred->right = NULL;
+            visit(node->val);
+            node = node->right;
+        }
+    }
+}
+
+// Morris ǰֻͬڽʱһε
+template <class Node, class Visit>
+void morrisPreOrder(Node* root, Visit&& visit) {
+    Node* node = root;
+    while (node) {
+        if (node->left == NULL) {
+            visit(node->val);
+            node = node->right;
+            continue;
+        }
+        Node* pred = node->left;
+        while (pred->right && pred->right != node) pred = pred->right;
+        if (pred->right == NULL) {
+            visit(node->val);
+            pred->right = node;
+            node = node->left;
+        }
+        else {
+            pred->right = NULL;
+            node = node->right;
+        }
+    }
+}
+
+// for (int v : inOrderRange(root)) ... ȡֵջΪ
+template <class Node>
+class InOrderIterator {
+private:
+    vector<Node*> stack;
+
+    void pushLeft(Node* node) {
+        for (; node; node = node->left) stack.push_back(node);
+    }
+
+public:
+    typedef forward_iterator_tag iterator_category;
+    typedef int value_type;
+    typedef ptrdiff_t difference_type;
+    typedef const int* pointer;
+    typedef const int& reference;
+
+    InOrderIterator() {}
+    explicit InOrderIterator(Node* root) { pushLeft(root); }
+
+    const int& operator*() const { return stack.back()->val; }
+
+    InOrderIterator& operator++() {
+        Node* node = stack.back();
+        stack.pop_back();
+        pushLeft(node->right);
+        return *this;
+    }
+
+    // ֻ end() Ƚ
+    bool operator==(const InOrderIterator& o) const { return stack.empty() == o.stack.empty(); }
+    bool operator!=(const InOrderIterator& o) const { return !(*this == o); }
+};
+
+template <class Node>
+struct InOrderRange {
+    Node* root;
+    InOrderIterator<Node> begin() const { return InOrderIterator<Node>(root); }
+    InOrderIterator<Node> end() const { return InOrderIterator<Node>(); }
+};
+
+template <class Node>
+InOrderRange<Node> inOrderRange(Node* root) {
+    return InOrderRange<Node>{ root };
+}
+
+//  to_chars ƴһдڵ cout
+class ValueWriter {
+private:
+    ostream& out;
+    vector<char> buf;
+    size_t len;
+
+public:
+    explicit ValueWriter(ostream& os, size_t capacity = 1 << 16) : out(os), buf(capacity), len(0) {}
+
+    ValueWriter(const ValueWriter&) = delete;
+    ValueWriter& operator=(const ValueWriter&) = delete;
+
+    ~ValueWriter() {
+        flush();
+    }
+
+    // дһһո
+    void operator()(int v) {
+        if (len + 12 > buf.size()) flush();
+        char* p = buf.data() + len;
+        p = to_chars(p, p + 11, v).ptr;
+        *p++ = ' ';
+        len = p - buf.data();
+    }
+
+    void flush() {
+        if (len) out.write(buf.data(), (streamsize)len);
+        len = 0;
+    }
+};
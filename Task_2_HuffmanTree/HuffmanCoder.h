@@ -0,0 +1,267 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+using namespace std;
+
+// ֽĹ淶
+// ֻ 256 볤ͬһȵ밴ֵ䣨 DEFLATE ͬ
+// λλǰȷλֽڵĵλÿ밴λţ
+// ʱֱ OR  64 λۼֽھд
+// ʱýλֱӲλ
+
+const int HUFFMAN_SYMBOLS = 256;
+const int HUFFMAN_MAX_BITS = 24;    // 볤ޣʱѹƽ
+
+struct HuffmanCode {
+    uint32_t bits;      // λֵ
+    uint32_t length;    // 볤0 ʾ÷Ų
+};
+
+//  v ĵ n λ
+inline uint32_t reverseBits(uint32_t v, int n) {
+    uint32_t r = 0;
+    for (int i = 0; i < n; ++i) {
+        r = (r << 1) | (v & 1);
+        v >>= 1;
+    }
+    return r;
+}
+
+inline void countFrequencies(const uint8_t* data, size_t n, uint64_t freq[HUFFMAN_SYMBOLS]) {
+    memset(freq, 0, HUFFMAN_SYMBOLS * sizeof(uint64_t));
+    for (size_t i = 0; i < n; ++i) freq[data[i]]++;
+}
+
+// 볤ɹ淶
+inline void canonicalCodes(const uint8_t lengths[HUFFMAN_SYMBOLS], HuffmanCode table[HUFFMAN_SYMBOLS]) {
+    uint32_t count[HUFFMAN_MAX_BITS + 1] = { 0 };
+    for (int s = 0; s < HUFFMAN_SYMBOLS; ++s) count[lengths[s]]++;
+    count[0] = 0;
+
+    uint32_t next[HUFFMAN_MAX_BITS + 1] = { 0 };
+    uint32_t code = 0;
+    for (int len = 1; len <= HUFFMAN_MAX_BITS; ++len) {
+        code = (code + count[len - 1]) << 1;
+        next[len] = code;
+    }
+    for (int s = 0; s < HUFFMAN_SYMBOLS; ++s) {
+        int len = lengths[s];
+        table[s].length = len;
+        table[s].bits = len ? reverseBits(next[len]++, len) : 0;
+    }
+}
+
+class HuffmanEncoder {
+private:
+    HuffmanCode table[HUFFMAN_SYMBOLS];
+
+public:
+    explicit HuffmanEncoder(const uint8_t lengths[HUFFMAN_SYMBOLS]) {
+        canonicalCodes(lengths, table);
+    }
+
+    const HuffmanCode& code(uint8_t symbol) const {
+        return table[symbol];
+    }
+
+    // İȫСÿ HUFFMAN_MAX_BITS λ 8 ֽڹд
+    static size_t maxEncodedBytes(size_t n) {
+        return (n * HUFFMAN_MAX_BITS + 7) / 8 + 8;
+    }
+
+    //  in[0..n)дλֽΪ (λ + 7) / 8
+    // ÿдһΣۼ 7 + 2 * 24 = 55 λ
+    // С˻x86/x64дԽЧд 8 ֽ
+    uint64_t encode(const uint8_t* in, size_t n, uint8_t* out) const {
+        uint8_t* p = out;
+        uint64_t buf = 0;
+        uint32_t used = 0;
+        size_t i = 0;
+        for (; i + 1 < n; i += 2) {
+            const HuffmanCode& a = table[in[i]];
+            const HuffmanCode& b = table[in[i + 1]];
+            buf |= (uint64_t)a.bits << used;
+            used += a.length;
+            buf |= (uint64_t)b.bits << used;
+            used += b.length;
+            memcpy(p, &buf, 8);
+            p += used >> 3;
+            buf >>= used & ~7u;
+            used &= 7;
+        }
+        if (i < n) {
+            const HuffmanCode& a = table[in[i]];
+            buf |= (uint64_t)a.bits << used;
+            used += a.length;
+            memcpy(p, &buf, 8);
+            p += used >> 3;
+            buf >>= used & ~7u;
+            used &= 7;
+        }
+        if (used) *p = (uint8_t)buf;    // һֽڵλ
+        return (uint64_t)(p - out) * 8 + used;
+    }
+};
+
+// 
+// һԽ FAST_BITS λΪ±꣺ͷǶ룬һ 3 Щλеķţ
+// һβͷǳǰ׺ָһŶúλһΡ
+// ʽ 24 λΪţÿ 8 λƫƣ24~28 λΪĵλΪλ
+// 29~31 λΪŸ0 ʾ
+class HuffmanDecoder {
+public:
+    static const int FAST_BITS = 11;
+
+private:
+    static const uint32_t FAST_MASK = (1u << FAST_BITS) - 1;
+
+    uint32_t multi[1 << FAST_BITS];     // һν 1~3 
+    uint32_t single[1 << FAST_BITS];    // һֻһţڽβ
+    vector<uint32_t> sub;               // sub[0] Ϊ 0ʾǷ
+    bool valid;
+
+    static uint32_t entry(uint32_t payload, uint32_t length, uint32_t count) {
+        return count << 29 | length << 24 | payload;
+    }
+
+    static uint32_t entryLength(uint32_t e) { return e >> 24 & 31; }
+    static uint32_t entryCount(uint32_t e) { return e >> 29; }
+
+public:
+    // 볤ͬ볤޻ǰ׺Kraft ʹ 1ʱ isValid() Ϊ false
+    explicit HuffmanDecoder(const uint8_t lengths[HUFFMAN_SYMBOLS]) : sub(1, 0), valid(true) {
+        memset(single, 0, sizeof(single));  // 0 ָ sub[0]Ƿ
+        memset(multi, 0, sizeof(multi));
+        uint64_t kraft = 0;
+        for (int s = 0; s < HUFFMAN_SYMBOLS; ++s) {
+            if (lengths[s] > HUFFMAN_MAX_BITS) valid = false;
+            else if (lengths[s]) kraft += 1ULL << (HUFFMAN_MAX_BITS - lengths[s]);
+        }
+        if (!valid || kraft > (1ULL << HUFFMAN_MAX_BITS)) {
+            valid = false;
+            return;
+        }
+
+        HuffmanCode table[HUFFMAN_SYMBOLS];
+        canonicalCodes(lengths, table);
+
+        // 룺ͷ±괦ظд
+        uint32_t subBits[1 << FAST_BITS] = { 0 };
+        for (int s = 0; s < HUFFMAN_SYMBOLS; ++s) {
+            uint32_t len = table[s].length;
+            if (len == 0) continue;
+            if (len <= (uint32_t)FAST_BITS) {
+                for (uint32_t i = table[s].bits; i <= FAST_MASK; i += 1u << len) single[i] = entry(s, len, 1);
+            }
+            else {
+                uint32_t& b = subBits[table[s].bits & FAST_MASK];
+                b = max(b, len - FAST_BITS);
+            }
+        }
+
+        // 룺ͬһǰ׺빲һŶСȡʣλ
+        for (uint32_t p = 0; p <= FAST_MASK; ++p) {
+            if (subBits[p] == 0) continue;
+            single[p] = entry((uint32_t)sub.size(), subBits[p], 0);
+            sub.resize(sub.size() + ((size_t)1 << subBits[p]), 0);
+        }
+        for (int s = 0; s < HUFFMAN_SYMBOLS; ++s) {
+            uint32_t len = table[s].length;
+            if (len <= (uint32_t)FAST_BITS) continue;
+            uint32_t link = single[table[s].bits & FAST_MASK];
+            uint32_t offset = link & 0xFFFFFF, size = 1u << entryLength(link);
+            for (uint32_t i = table[s].bits >> FAST_BITS; i < size; i += 1u << (len - FAST_BITS)) sub[offset + i] = entry(s, len, 1);
+        }
+
+        // űһźʣµ֪λһͽŽ
+        for (uint32_t i = 0; i <= FAST_MASK; ++i) {
+            uint32_t e = single[i];
+            if (entryCount(e) == 0) {
+                multi[i] = e;
+                continue;
+            }
+            uint32_t symbols = e & 0xFF, total = entryLength(e), count = 1;
+            while (count < 3) {
+                uint32_t next = single[i >> total];     // λδ֪λ 0 飬ֻܲǵĶ
+                if (entryCount(next) == 0 || total + entryLength(next) > (uint32_t)FAST_BITS) break;
+                symbols |= (next & 0xFF) << (8 * count);
+                total += entryLength(next);
+                ++count;
+            }
+            multi[i] = entry(symbols, total, count);
+        }
+    }
+
+    HuffmanDecoder(const HuffmanDecoder&) = delete;
+    HuffmanDecoder& operator=(const HuffmanDecoder&) = delete;
+
+    bool isValid() const {
+        return valid;
+    }
+
+    //  in[0..inBytes)  n ŵ outǷλʱ false
+    // ÿβλ󻺳 56 λαÿ 24 λ
+    // ͬһСֶд
+    bool decode(const uint8_t* in, size_t inBytes, uint8_t* out, size_t n) const {
+        if (!valid) return n == 0;
+        const uint8_t* p = in;
+        const uint8_t* end = in + inBytes;
+        uint8_t* o = out;
+        uint8_t* oEnd = out + n;
+        uint64_t buf = 0;
+        int avail = 0;      // еЧλλľɸ
+
+        auto refill = [&]() {
+            if (end - p >= 8) {
+                uint64_t w;
+                memcpy(&w, p, 8);
+                buf |= w << avail;
+                p += (63 - avail) >> 3;
+                avail |= 56;
+            }
+            else {
+                while (avail <= 56 && p < end) {
+                    buf |= (uint64_t)*p++ << avail;
+                    avail += 8;
+                }
+            }
+        };
+
+        // һд 4 ֽڣ3  + 1 ֽڣβд o + 7
+        while (oEnd - o >= 8) {
+            refill();
+            for (int k = 0; k < 2; ++k) {
+                uint32_t e = multi[buf & FAST_MASK];
+                if (entryCount(e)) {
+                    memcpy(o, &e, 4);
+                    o += entryCount(e);
+                }
+                else {
+                    e = sub[(e & 0xFFFFFF) + ((buf >> FAST_BITS) & ((1u << entryLength(e)) - 1))];
+                    if (entryCount(e) == 0) return false;
+                    *o++ = (uint8_t)e;
+                }
+                uint32_t len = entryLength(e);
+                buf >>= len;
+                avail -= (int)len;
+            }
+        }
+        while (o < oEnd) {
+            refill();
+            uint32_t e = single[buf & FAST_MASK];
+            if (entryCount(e) == 0) {
+                e = sub[(e & 0xFFFFFF) + ((buf >> FAST_BITS) & ((1u << entryLength(e)) - 1))];
+                if (entryCount(e) == 0) return false;
+            }
+            *o++ = (uint8_t)e;
+            uint32_t len = entryLength(e);
+            buf >>= len;
+            avail -= (int)len;
+        }
+        return avail >= 0;
+    }
+};
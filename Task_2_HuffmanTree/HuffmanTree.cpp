@@ -1,19 +1,22 @@
 #include <iostream>
 #include <string>
 #include <queue>
-#include <unordered_map>
 #include <vector>
 #include <iomanip>
+#include <chrono>
+#include <limits>
+#include <random>
+#include "HuffmanCoder.h"
 
 using namespace std;
 
 // ڵṹ
 struct Node {
-    char ch;                // 洢ַ
-    int freq;               // 洢Ƶ
+    unsigned char ch;       // 洢ַֽڣ
+    uint64_t freq;          // 洢Ƶ
     Node* left, * right;     // ӽڵָ
 
-    Node(char character, int frequency) {
+    Node(unsigned char character, uint64_t frequency) {
         ch = character;
         freq = frequency;
         left = right = nullptr;
@@ -28,20 +31,18 @@ struct Compare {
     }
 };
 
-// ݹɱ
-void generateCodes(Node* root, string str, unordered_map<char, string>& huffmanCode) {
+// ݹҶӵȾǸַ볤볤
+int assignLengths(Node* root, int depth, uint8_t lengths[]) {
     if (root == nullptr)
-        return;
+        return 0;
 
     // Ҷӽڵ㣨ûҺӣҵһַ
     if (!root->left && !root->right) {
-        huffmanCode[root->ch] = str;
+        lengths[root->ch] = (uint8_t)min(depth, 255);
+        return depth;
     }
 
-    // ݹ '0'
-    generateCodes(root->left, str + "0", huffmanCode);
-    // ݹ '1'
-    generateCodes(root->right, str + "1", huffmanCode);
+    return max(assignLengths(root->left, depth + 1, lengths), assignLengths(root->right, depth + 1, lengths));
 }
 
 // ͷڴ
@@ -52,99 +53,306 @@ void deleteTree(Node* root) {
     delete root;
 }
 
+// Ƶʽÿַ볤δֵַ볤Ϊ 0
+// 볤 HUFFMAN_MAX_BITS ʱƵʼؽֱޣ
+// ֻһַʱ 1 λ
+void buildCodeLengths(const uint64_t freq[], uint8_t lengths[]) {
+    vector<uint64_t> f(freq, freq + HUFFMAN_SYMBOLS);
+    while (true) {
+        memset(lengths, 0, HUFFMAN_SYMBOLS);
+
+        // ַڵȶ
+        priority_queue<Node*, vector<Node*>, Compare> pq;
+        for (int c = 0; c < HUFFMAN_SYMBOLS; ++c) {
+            if (f[c]) pq.push(new Node((unsigned char)c, f[c]));
+        }
+        if (pq.empty()) return;
+        if (pq.size() == 1) {
+            lengths[pq.top()->ch] = 1;
+            delete pq.top();
+            return;
+        }
+
+        // нڵ1ʱѭ
+        while (pq.size() != 1) {
+            // ȡƵСڵ
+            Node* left = pq.top(); pq.pop();
+            Node* right = pq.top(); pq.pop();
+
+            // һµڲڵ㣬ƵΪӽڵ֮
+            // '$' ռλ洢ʵıַ
+            Node* top = new Node('$', left->freq + right->freq);
+            top->left = left;
+            top->right = right;
+            pq.push(top);
+        }
+
+        // ʣµһڵǸڵ
+        Node* root = pq.top();
+        int maxLength = assignLengths(root, 0, lengths);
+        deleteTree(root);
+        if (maxLength <= HUFFMAN_MAX_BITS) return;
+
+        for (uint64_t& x : f) {
+            if (x) x = max<uint64_t>(1, x >> 1);
+        }
+    }
+}
+
+// ַʾʽո񡢻кͲɴӡֽڵ
+string charDisplay(unsigned char c) {
+    if (c == ' ') return "' '";
+    if (c == '\n') return "\\n";
+    if (c < 0x20 || c >= 0x7f) {
+        const char* hex = "0123456789ABCDEF";
+        return string("\\x") + hex[c >> 4] + hex[c & 15];
+    }
+    return string(1, (char)c);
+}
+
+// ֵ˳д '0'/'1'ʾ
+string codeDisplay(const HuffmanCode& code) {
+    string s;
+    for (uint32_t i = 0; i < code.length; ++i) s += (code.bits >> i & 1) ? '1' : '0';
+    return s;
+}
+
 // ߼
 void buildHuffmanTree(string text) {
-    // 1. ͳַƵ
-    unordered_map<char, int> freqMap;
-    for (char c : text) {
-        freqMap[c]++;
+    if (text.empty()) {
+        cout << "Ϊգ롣" << endl;
+        return;
     }
+    const uint8_t* data = (const uint8_t*)text.data();
+
+    // 1. ͳַƵ
+    uint64_t freq[HUFFMAN_SYMBOLS];
+    countFrequencies(data, text.size(), freq);
 
     // ַƵʱ
     cout << "----------------------------------------" << endl;
     cout << "Step 1: ַƵͳƱ" << endl;
     cout << "----------------------------------------" << endl;
     cout << left << setw(10) << "Char" << setw(10) << "Freq" << endl;
-    for (auto pair : freqMap) {
-        // ΪʾзͿոʾ
-        string charDisplay;
-        if (pair.first == ' ') charDisplay = "' '";
-        else if (pair.first == '\n') charDisplay = "\\n";
-        else charDisplay = string(1, pair.first);
-
-        cout << left << setw(10) << charDisplay << setw(10) << pair.second << endl;
+    for (int c = 0; c < HUFFMAN_SYMBOLS; ++c) {
+        if (freq[c]) cout << left << setw(10) << charDisplay((unsigned char)c) << setw(10) << freq[c] << endl;
     }
     cout << "----------------------------------------" << endl << endl;
 
-    // 2. ַڵȶ
-    priority_queue<Node*, vector<Node*>, Compare> pq;
-    for (auto pair : freqMap) {
-        pq.push(new Node(pair.first, pair.second));
-    }
-
-    // 3. 
-    // нڵ1ʱѭ
-    while (pq.size() != 1) {
-        // ȡƵСڵ
-        Node* left = pq.top(); pq.pop();
-        Node* right = pq.top(); pq.pop();
-
-        // һµڲڵ㣬ƵΪӽڵ֮
-        // '$' ռλ洢ʵıַ
-        int sum = left->freq + right->freq;
-        Node* top = new Node('$', sum);
-
-        top->left = left;
-        top->right = right;
-
-        // ½ڵŻض
-        pq.push(top);
-    }
-
-    // ʣµһڵǸڵ
-    Node* root = pq.top();
-
-    // 4. ɹ
-    unordered_map<char, string> huffmanCode;
-    generateCodes(root, "", huffmanCode);
+    // 2~4. õ볤ɹ淶
+    uint8_t lengths[HUFFMAN_SYMBOLS];
+    buildCodeLengths(freq, lengths);
+    HuffmanEncoder encoder(lengths);
 
     // 
     cout << "----------------------------------------" << endl;
     cout << "Step 2: " << endl;
     cout << "----------------------------------------" << endl;
     cout << left << setw(10) << "Char" << setw(15) << "Code" << endl;
-    for (auto pair : huffmanCode) {
-        string charDisplay;
-        if (pair.first == ' ') charDisplay = "' '";
-        else if (pair.first == '\n') charDisplay = "\\n";
-        else charDisplay = string(1, pair.first);
-
-        cout << left << setw(10) << charDisplay << setw(15) << pair.second << endl;
+    for (int c = 0; c < HUFFMAN_SYMBOLS; ++c) {
+        if (freq[c]) cout << left << setw(10) << charDisplay((unsigned char)c) << setw(15) << codeDisplay(encoder.code((uint8_t)c)) << endl;
     }
     cout << "----------------------------------------" << endl << endl;
 
-    // 5. ʾԭʼַı
+    // 5. Ϊյλٰλʾ
     cout << "----------------------------------------" << endl;
     cout << "Step 3: ԭʼַ:" << endl;
     cout << "----------------------------------------" << endl;
-    string encodedString = "";
-    for (char c : text) {
-        encodedString += huffmanCode[c];
-    }
-    cout << encodedString << endl << endl;
+    vector<uint8_t> packed(HuffmanEncoder::maxEncodedBytes(text.size()));
+    uint64_t compressedBits = encoder.encode(data, text.size(), packed.data());
+    packed.resize((size_t)((compressedBits + 7) / 8));
+    string bitsDisplay;
+    bitsDisplay.reserve((size_t)compressedBits);
+    for (uint64_t i = 0; i < compressedBits; ++i) bitsDisplay += (packed[(size_t)(i >> 3)] >> (i & 7) & 1) ? '1' : '0';
+    cout << bitsDisplay << endl << endl;
 
     // ѹϢ
-    int originalBits = text.length() * 8;
-    int compressedBits = encodedString.length();
+    uint64_t originalBits = (uint64_t)text.length() * 8;
     cout << "ԭʼС: " << originalBits << " bits" << endl;
-    cout << "ѹС: " << compressedBits << " bits" << endl;
-    cout << "ѹ: " << (float)compressedBits / originalBits * 100 << "%" << endl;
+    cout << "ѹС: " << compressedBits << " bits" << packed.size() << " ֽڣ" << endl;
+    cout << "ѹ: " << (float)compressedBits / originalBits * 100 << "%" << endl << endl;
+
+    // 6. 룬ԭԭ
+    cout << "----------------------------------------" << endl;
+    cout << "Step 4: :" << endl;
+    cout << "----------------------------------------" << endl;
+    HuffmanDecoder decoder(lengths);
+    string decoded(text.size(), '\0');
+    bool ok = decoder.decode(packed.data(), packed.size(), (uint8_t*)&decoded[0], decoded.size());
+    cout << decoded << endl;
+    cout << (ok && decoded == text ? "ԭһ" : "ʧ") << endl;
+}
 
-    // ڴ
-    deleteTree(root);
+// ϣӢĵƴɵıԼֲƫбĶ
+vector<uint8_t> makeTextCorpus(size_t n, mt19937& rng) {
+    const char* words[] = { "the", "of", "and", "to", "a", "in", "is", "that", "program", "tree",
+        "node", "data", "value", "Huffman", "code", "with", "for", "as", "on", "by",
+        "compression", "frequency", "symbol", "table", "bits", "string", "encode", "output" };
+    const size_t W = sizeof(words) / sizeof(words[0]);
+    vector<uint8_t> text;
+    text.reserve(n + 16);
+    while (text.size() < n) {
+        const char* w = words[min(rng() % W, rng() % W)];  // ǰĴʸ
+        text.insert(text.end(), w, w + strlen(w));
+        uint32_t r = rng() % 16;
+        text.push_back(r == 0 ? '.' : r == 1 ? ',' : r == 2 ? '\n' : ' ');
+    }
+    text.resize(n);
+    return text;
+}
+
+vector<uint8_t> makeBinaryCorpus(size_t n, mt19937& rng) {
+    vector<uint8_t> data(n);
+    geometric_distribution<int> small(0.08);
+    for (uint8_t& b : data) {
+        uint32_t r = rng();
+        b = (r & 3) == 0 ? (uint8_t)(r >> 8) : (uint8_t)min(small(rng), 255);  // СֵӶֽ࣬
+    }
+    return data;
+}
+
+//  + һΣ黹ԭصһֽڵλᱻʶ
+bool roundTrip(const vector<uint8_t>& data) {
+    uint64_t freq[HUFFMAN_SYMBOLS];
+    countFrequencies(data.data(), data.size(), freq);
+    uint8_t lengths[HUFFMAN_SYMBOLS];
+    buildCodeLengths(freq, lengths);
+    HuffmanEncoder encoder(lengths);
+    HuffmanDecoder decoder(lengths);
+
+    vector<uint8_t> packed(HuffmanEncoder::maxEncodedBytes(data.size()));
+    uint64_t bits = encoder.encode(data.data(), data.size(), packed.data());
+    size_t bytes = (size_t)((bits + 7) / 8);
+    packed.resize(bytes);
+
+    vector<uint8_t> decoded(data.size());
+    if (!decoder.decode(packed.data(), bytes, decoded.data(), decoded.size()) || decoded != data) return false;
+    if (bytes > 0 && decoder.decode(packed.data(), bytes - 1, decoded.data(), decoded.size())) return false;
+    return true;
+}
+
+// ȷԲԣ߽ѹƽĳ루߶ıͶϡֲ
+void runRoundTripTests() {
+    mt19937 rng(99);
+    int failed = 0;
+    auto check = [&](const char* name, bool ok) {
+        cout << left << setw(28) << name << (ok ? "ͨ" : "ʧ") << "\n";
+        if (!ok) ++failed;
+    };
+
+    check("", roundTrip(vector<uint8_t>()));
+    check("ֽ", roundTrip(vector<uint8_t>(1, 'x')));
+    check("ֻһַ", roundTrip(vector<uint8_t>(1000, 'a')));
+    check("ַ", roundTrip(vector<uint8_t>{ 'a', 'b', 'b', 'a', 'b' }));
+
+    vector<uint8_t> all(256 * 40);
+    for (size_t i = 0; i < all.size(); ++i) all[i] = (uint8_t)i;
+    check("256 ַȷֲ", roundTrip(all));
+
+    // ƵΪ쳲ʱ˻볤ᳬ޲ѹƽ
+    vector<uint8_t> fib;
+    uint64_t a = 1, b = 1;
+    for (int c = 0; c < 30; ++c) {
+        fib.insert(fib.end(), (size_t)a, (uint8_t)c);
+        uint64_t t = a + b;
+        a = b;
+        b = t;
+    }
+    shuffle(fib.begin(), fib.end(), rng);
+    check("쳲Ƶʣ룩", roundTrip(fib));
+
+    check("Ӣı 1MB", roundTrip(makeTextCorpus(1 << 20, rng)));
+    check(" 1MB", roundTrip(makeBinaryCorpus(1 << 20, rng)));
+
+    bool ok = true;
+    for (int t = 0; t < 500 && ok; ++t) {
+        vector<uint8_t> data(rng() % 5000);
+        uint32_t alphabet = 1 + rng() % 256;
+        for (uint8_t& x : data) x = (uint8_t)min(rng() % alphabet, rng() % alphabet);
+        ok = roundTrip(data);
+    }
+    check("ֲ x500", ok);
+
+    uint8_t bad[HUFFMAN_SYMBOLS] = { 1, 1, 1 };     //  1 λ벻ǰ׺
+    HuffmanDecoder invalid(bad);
+    check("ܾǷ볤", !invalid.isValid());
+
+    cout << (failed == 0 ? "\nȫͨ\n" : "\nʧܵĲ\n");
+}
+
+// ܲ
+void runBenchmark() {
+    const size_t N = 64 << 20;
+    const int ROUNDS = 5;
+    mt19937 rng(2024);
+
+    struct Corpus { const char* name; vector<uint8_t> data; };
+    Corpus corpora[] = { { "ı", makeTextCorpus(N, rng) }, { "", makeBinaryCorpus(N, rng) } };
+
+    cout << "\n      С(MB)   ѹ(%)   (ms)   (MB/s)   (MB/s)\n";
+    for (Corpus& c : corpora) {
+        const uint8_t* data = c.data.data();
+        size_t n = c.data.size();
+
+        auto t0 = chrono::steady_clock::now();
+        uint64_t freq[HUFFMAN_SYMBOLS];
+        countFrequencies(data, n, freq);
+        uint8_t lengths[HUFFMAN_SYMBOLS];
+        buildCodeLengths(freq, lengths);
+        HuffmanEncoder encoder(lengths);
+        HuffmanDecoder decoder(lengths);
+        auto t1 = chrono::steady_clock::now();
+
+        vector<uint8_t> out(HuffmanEncoder::maxEncodedBytes(n));
+        uint64_t bits = 0;
+        double bestEncode = 1e30;
+        for (int r = 0; r < ROUNDS; ++r) {
+            auto a = chrono::steady_clock::now();
+            bits = encoder.encode(data, n, out.data());
+            auto b = chrono::steady_clock::now();
+            bestEncode = min(bestEncode, chrono::duration<double>(b - a).count());
+        }
+
+        size_t bytes = (size_t)((bits + 7) / 8);
+        vector<uint8_t> decoded(n);
+        bool ok = true;
+        double bestDecode = 1e30;
+        for (int r = 0; r < ROUNDS; ++r) {
+            auto a = chrono::steady_clock::now();
+            ok = decoder.decode(out.data(), bytes, decoded.data(), n) && ok;
+            auto b = chrono::steady_clock::now();
+            bestDecode = min(bestDecode, chrono::duration<double>(b - a).count());
+        }
+        ok = ok && decoded == c.data;
+
+        cout << left << setw(10) << c.name << right << fixed << setprecision(1)
+            << setw(8) << n / 1048576.0 << setw(12) << bits / 8.0 / n * 100
+            << setw(11) << chrono::duration<double, milli>(t1 - t0).count()
+            << setw(13) << n / bestEncode / 1e6 << setw(13) << n / bestDecode / 1e6
+            << (ok ? "" : "  ") << "\n";
+        cout.unsetf(ios::fixed);
+    }
 }
 
 int main() {
+    int mode;
+    cout << "ѡģʽ:\n";
+    cout << "1. ʾ\n";
+    cout << "2. ܲ\n";
+    cout << "3. ȷԲ\n";
+    cout << "ѡ (1-3): ";
+    cin >> mode;
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+
+    if (mode == 2) {
+        runBenchmark();
+        return 0;
+    }
+    if (mode == 3) {
+        runRoundTripTests();
+        return 0;
+    }
+
     // ʵ
     string text = "Programmers are perpetual optimists. Most of them think that the way to write a program is to run to the keyboard and start typing. Shortly thereafter the fully debugged program is finished.";
     cout << "ʵ: " << endl << "\"" << text << "\"" << endl << endl;
@@ -157,4 +365,4 @@ int main() {
     buildHuffmanTree(input);
 
     return 0;
-}
\ No newline at end of file
+}